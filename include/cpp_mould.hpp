@@ -5,12 +5,26 @@
 
 #include "cpp_mould/compile.hpp"
 #include "cpp_mould/engine.hpp"
+#include "cpp_mould/named.hpp"
 #include "cpp_mould/runtime_driver.hpp"
 #include "cpp_mould/constexpr_driver.hpp"
+#include "cpp_mould/defer.hpp"
+#include "cpp_mould/ring.hpp"
+#include "cpp_mould/async.hpp"
+#include "cpp_mould/batch.hpp"
+#include "cpp_mould/stamp.hpp"
+#include "cpp_mould/table.hpp"
 
 #include "cpp_mould/arguments/int.hpp"
 #include "cpp_mould/arguments/float.hpp"
 #include "cpp_mould/arguments/strings.hpp"
 #include "cpp_mould/arguments/pointer.hpp"
+#include "cpp_mould/arguments/bytes.hpp"
+#include "cpp_mould/arguments/range.hpp"
+#include "cpp_mould/arguments/chrono.hpp"
+#include "cpp_mould/arguments/enum.hpp"
+#include "cpp_mould/arguments/human.hpp"
+#include "cpp_mould/arguments/fixed.hpp"
+#include "cpp_mould/arguments/net.hpp"
 
 #endif
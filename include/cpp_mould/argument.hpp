@@ -53,9 +53,18 @@ namespace mould {
     EXPONENT,
     fpoint,
     FPOINT,
+    general,
+    GENERAL,
     pointer,
     string,
     character,
+    json,
+    quoted,
+    hexdump,
+    base64,
+    percent,
+    bytesize,
+    timespan,
   };
 
   template<AutoFormattingChoice choice>
@@ -94,6 +103,12 @@ namespace mould {
   template<typename Formatter>
   NotImplemented format_FPOINT(const NotImplemented& value, Formatter formatter);
 
+  template<typename Formatter>
+  NotImplemented format_general(const NotImplemented& value, Formatter formatter);
+
+  template<typename Formatter>
+  NotImplemented format_GENERAL(const NotImplemented& value, Formatter formatter);
+
   template<typename Formatter>
   NotImplemented format_pointer(const NotImplemented& value, Formatter formatter);
 
@@ -102,6 +117,27 @@ namespace mould {
 
   template<typename Formatter>
   NotImplemented format_character(const NotImplemented& value, Formatter formatter);
+
+  template<typename Formatter>
+  NotImplemented format_json(const NotImplemented& value, Formatter formatter);
+
+  template<typename Formatter>
+  NotImplemented format_quoted(const NotImplemented& value, Formatter formatter);
+
+  template<typename Formatter>
+  NotImplemented format_hexdump(const NotImplemented& value, Formatter formatter);
+
+  template<typename Formatter>
+  NotImplemented format_base64(const NotImplemented& value, Formatter formatter);
+
+  template<typename Formatter>
+  NotImplemented format_percent(const NotImplemented& value, Formatter formatter);
+
+  template<typename Formatter>
+  NotImplemented format_bytesize(const NotImplemented& value, Formatter formatter);
+
+  template<typename Formatter>
+  NotImplemented format_timespan(const NotImplemented& value, Formatter formatter);
 }
 
 #endif
@@ -0,0 +1,222 @@
+#ifndef CPP_MOULD_ARGUMENTS_BYTES_HPP
+#define CPP_MOULD_ARGUMENTS_BYTES_HPP
+/* Byte spans as contiguous hex, hex dump or base64. */
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "../argument.hpp"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace mould::internal {
+  template<typename B>
+  constexpr bool is_byte = std::is_same_v<std::remove_const_t<B>, std::byte>
+    || std::is_same_v<std::remove_const_t<B>, std::uint8_t>;
+
+  template<typename B, size_t E>
+  inline const unsigned char* byte_data(std::span<B, E> value) {
+    return reinterpret_cast<const unsigned char*>(value.data());
+  }
+
+  // Two digits per byte, 16 bytes at a time: the nibbles are interleaved and
+  // offset to '0', those above 9 further to the letters.
+  inline char* encode_hex(const unsigned char* in, size_t count, char* out, bool upper) {
+    const char* const digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i letter = _mm_set1_epi8(upper ? 'A' - '0' - 10 : 'a' - '0' - 10);
+    const auto to_digits = [&](__m128i nibbles) {
+      const __m128i above_nine = _mm_and_si128(_mm_cmpgt_epi8(nibbles, nine), letter);
+      return _mm_add_epi8(_mm_add_epi8(nibbles, zero), above_nine);
+    };
+
+    for(; i + 16 <= count; i += 16) {
+      const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      const __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+      const __m128i low = _mm_and_si128(bytes, mask);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), to_digits(_mm_unpacklo_epi8(high, low)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), to_digits(_mm_unpackhi_epi8(high, low)));
+      out += 32;
+    }
+#endif
+    for(; i < count; i++) {
+      *out++ = digits[in[i] >> 4];
+      *out++ = digits[in[i] & 0xF];
+    }
+    return out;
+  }
+
+  constexpr size_t hexdump_length(size_t count, size_t group) {
+    return count ? 2*count + (count - 1)/group : 0;
+  }
+
+  // Groups of `group` bytes in hex, separated by a space.
+  inline char* encode_hexdump(const unsigned char* in, size_t count, size_t group, char* out) {
+    for(size_t i = 0; i < count; i += group) {
+      if(i) *out++ = ' ';
+      out = encode_hex(in + i, std::min(group, count - i), out, false);
+    }
+    return out;
+  }
+
+  constexpr size_t base64_length(size_t count) {
+    return (count + 2)/3*4;
+  }
+
+  // Standard alphabet with padding. With SSSE3, 12 bytes are split into 16
+  // sextets by shuffles and multiplies and translated with a small lookup
+  // (Muła and Lemire). Each step loads 16 bytes, the last ones are scalar.
+  inline char* encode_base64(const unsigned char* in, size_t count, char* out) {
+    constexpr char alphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t i = 0;
+#if defined(__SSSE3__)
+    const __m128i spread = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m128i shift = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+      '/' - 63, 'A', 0, 0);
+
+    for(; i + 16 <= count; i += 12) {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      bytes = _mm_shuffle_epi8(bytes, spread);
+      const __m128i t0 = _mm_and_si128(bytes, _mm_set1_epi32(0x0fc0fc00));
+      const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+      const __m128i t2 = _mm_and_si128(bytes, _mm_set1_epi32(0x003f03f0));
+      const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+      const __m128i sextets = _mm_or_si128(t1, t3);
+
+      __m128i range = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+      const __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+      range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+      const __m128i chars = _mm_add_epi8(_mm_shuffle_epi8(shift, range), sextets);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), chars);
+      out += 16;
+    }
+#endif
+    for(; i + 3 <= count; i += 3) {
+      const uint32_t bits = (uint32_t{in[i]} << 16) | (uint32_t{in[i + 1]} << 8) | in[i + 2];
+      *out++ = alphabet[(bits >> 18) & 0x3F];
+      *out++ = alphabet[(bits >> 12) & 0x3F];
+      *out++ = alphabet[(bits >> 6) & 0x3F];
+      *out++ = alphabet[bits & 0x3F];
+    }
+
+    if(i < count) {
+      const bool two = count - i == 2;
+      const uint32_t bits = (uint32_t{in[i]} << 16) | (two ? uint32_t{in[i + 1]} << 8 : 0);
+      *out++ = alphabet[(bits >> 18) & 0x3F];
+      *out++ = alphabet[(bits >> 12) & 0x3F];
+      *out++ = two ? alphabet[(bits >> 6) & 0x3F] : '=';
+      *out++ = '=';
+    }
+    return out;
+  }
+
+  // Encoded data of known `length` with the padding of the format. `encode`
+  // writes all of it into engine buffer space, `stream` appends it in pieces
+  // if the engine has none.
+  template<typename Formatter, typename Encode, typename Stream>
+  FormattingResult format_encoded(Formatter& formatter, size_t length, Encode&& encode, Stream&& stream) {
+    if(char* buffer = formatter.show_buf(formatter.padded_size(length))) {
+      encode(buffer);
+      formatter.put_padded(buffer, length, Alignment::Left);
+    } else {
+      formatter.append_fill_before(length, Alignment::Left);
+      stream();
+      formatter.append_fill_after(length, Alignment::Left);
+    }
+    return FormattingResult::Success;
+  }
+
+  constexpr size_t encode_chunk = 256;
+
+  template<typename Formatter>
+  void append_hex(const unsigned char* in, size_t count, Formatter& formatter, bool upper) {
+    char chunk[encode_chunk];
+    for(size_t i = 0; i < count; i += encode_chunk/2) {
+      const char* end = encode_hex(in + i, std::min(encode_chunk/2, count - i), chunk, upper);
+      formatter.append(std::string_view{chunk, static_cast<size_t>(end - chunk)});
+    }
+  }
+
+  template<typename Formatter>
+  FormattingResult format_hex_bytes(const unsigned char* in, size_t count, Formatter& formatter, bool upper) {
+    return format_encoded(formatter, 2*count,
+      [&](char* buffer) { encode_hex(in, count, buffer, upper); },
+      [&]() { append_hex(in, count, formatter, upper); });
+  }
+}
+
+namespace mould {
+  /* Standard implementation for spans of std::byte and uint8_t. The
+   * precision of the hex dump is the number of bytes per group, 1 if not
+   * given.
+   */
+  template<typename B, size_t E, typename Choice>
+  constexpr auto format_auto(const std::span<B, E>&, Choice choice)
+  -> std::enable_if_t<internal::is_byte<B>, AutoFormatting<AutoFormattingChoice::hex>> {
+    return AutoFormatting<AutoFormattingChoice::hex> { };
+  }
+
+  template<typename B, size_t E, typename Formatter>
+  auto format_hex(const std::span<B, E>& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_byte<B>, FormattingResult> {
+    return internal::format_hex_bytes(internal::byte_data(value), value.size(), formatter, false);
+  }
+
+  template<typename B, size_t E, typename Formatter>
+  auto format_HEX(const std::span<B, E>& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_byte<B>, FormattingResult> {
+    return internal::format_hex_bytes(internal::byte_data(value), value.size(), formatter, true);
+  }
+
+  template<typename B, size_t E, typename Formatter>
+  auto format_hexdump(const std::span<B, E>& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_byte<B>, FormattingResult> {
+    const auto& format = formatter.format();
+    const size_t group = format.has_precision && format.precision ? format.precision : 1;
+    const auto in = internal::byte_data(value);
+    const size_t count = value.size();
+
+    return internal::format_encoded(formatter, internal::hexdump_length(count, group),
+      [&](char* buffer) { internal::encode_hexdump(in, count, group, buffer); },
+      [&]() {
+        for(size_t i = 0; i < count; i += group) {
+          if(i) formatter.append(' ');
+          internal::append_hex(in + i, std::min(group, count - i), formatter, false);
+        }
+      });
+  }
+
+  template<typename B, size_t E, typename Formatter>
+  auto format_base64(const std::span<B, E>& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_byte<B>, FormattingResult> {
+    const auto in = internal::byte_data(value);
+    const size_t count = value.size();
+
+    return internal::format_encoded(formatter, internal::base64_length(count),
+      [&](char* buffer) { internal::encode_base64(in, count, buffer); },
+      [&]() {
+        // Whole groups of three bytes per chunk, the padding comes last.
+        constexpr size_t step = internal::encode_chunk/4*3;
+        char chunk[internal::encode_chunk];
+        for(size_t i = 0; i < count; i += step) {
+          const char* end = internal::encode_base64(in + i, std::min(step, count - i), chunk);
+          formatter.append(std::string_view{chunk, static_cast<size_t>(end - chunk)});
+        }
+      });
+  }
+}
+
+#endif
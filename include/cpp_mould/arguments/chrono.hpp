@@ -0,0 +1,386 @@
+#ifndef CPP_MOULD_ARGUMENTS_CHRONO_HPP
+#define CPP_MOULD_ARGUMENTS_CHRONO_HPP
+/* System clock time points and durations with strftime-like patterns.
+ *
+ * The pattern is the spec after the kind, e.g. `{:%Y-%m-%dT%H:%M:%S.%f}`, or
+ * after a '|'. Time points are always in UTC, there is no lookup of time
+ * zones or locales. Supported for time points:
+ *
+ *   %Y year     %y year % 100   %m month    %d day      %j day of year
+ *   %H hour     %M minute       %S second   %F %Y-%m-%d %T %H:%M:%S
+ *   %f micro-, %Nf N digits of the fraction of the second
+ *   %z +0000    %Z UTC          %% %
+ *
+ * Durations know %H (all hours), %M, %S, %f / %Nf, %Q (count), %q (unit) and
+ * %%, a negative duration gets a single leading '-'. Other conversions are
+ * copied as they are.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ratio>
+#include <string_view>
+#include <type_traits>
+
+#include "../argument.hpp"
+#include "digits.hpp"
+
+namespace mould::internal {
+  // Days since 1970-01-01 in the proleptic Gregorian calendar, after Howard
+  // Hinnant's chrono-compatible low-level date algorithms.
+  constexpr int64_t days_from_civil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153*(month > 2 ? month - 3 : month + 9) + 2)/5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe/4 - yoe/100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+  }
+
+  struct CivilTime {
+    int64_t year;
+    unsigned month, day, day_of_year;
+    unsigned hour, minute, second;
+  };
+
+  constexpr CivilTime civil_from_seconds(int64_t seconds) {
+    int64_t days = seconds / 86400;
+    int64_t rest = seconds % 86400;
+    if(rest < 0) {
+      rest += 86400;
+      days -= 1;
+    }
+
+    const int64_t z = days + 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+    const unsigned doy = doe - (365*yoe + yoe/4 - yoe/100);
+    const unsigned mp = (5*doy + 2)/153;
+
+    CivilTime civil = {};
+    civil.day = doy - (153*mp + 2)/5 + 1;
+    civil.month = mp < 10 ? mp + 3 : mp - 9;
+    civil.year = static_cast<int64_t>(yoe) + era * 400 + (civil.month <= 2);
+    civil.day_of_year = static_cast<unsigned>(days - days_from_civil(civil.year, 1, 1)) + 1;
+    civil.hour = static_cast<unsigned>(rest / 3600);
+    civil.minute = static_cast<unsigned>(rest / 60 % 60);
+    civil.second = static_cast<unsigned>(rest % 60);
+    return civil;
+  }
+
+  inline char* write_year(char* out, int64_t year) {
+    if(year < 0) *out++ = '-';
+    const uint64_t value = year < 0 ? 0 - static_cast<uint64_t>(year) : year;
+    return write_fixed_digits(out, value, std::max(count_digits(value), 4u));
+  }
+
+  // The first `digits` digits of the fraction of a second.
+  inline char* write_fraction(char* out, uint32_t nanoseconds, unsigned digits) {
+    constexpr uint32_t scale[] =
+      { 1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1 };
+    return write_fixed_digits(out, nanoseconds / scale[digits], digits);
+  }
+
+  // A single conversion writes at most this many characters
+  constexpr size_t max_conversion_length = 24;
+
+  // Expands the pattern into `out` until it is consumed or the next part
+  // might not fit. `convert(conversion, digits, out)` writes one conversion
+  // and returns its end, or nullptr if it does not know it. Returns the
+  // number of characters written, the rest of the pattern stays in `pattern`.
+  template<typename Convert>
+  size_t expand_pattern(std::string_view& pattern, char* out, size_t capacity, Convert&& convert) {
+    char* const begin = out;
+    char* const end = out + capacity;
+    size_t at = 0;
+
+    while(at < pattern.size()) {
+      if(pattern[at] != '%' || at + 1 == pattern.size()) {
+        if(out == end) break;
+        *out++ = pattern[at++];
+        continue;
+      }
+
+      if(static_cast<size_t>(end - out) < max_conversion_length) break;
+
+      size_t next = at + 1;
+      unsigned digits = 0;
+      if(pattern[next] >= '1' && pattern[next] <= '9' && next + 1 < pattern.size()) {
+        digits = pattern[next] - '0';
+        next++;
+      }
+
+      char* const converted = convert(pattern[next], digits, out);
+      if(converted) {
+        out = converted;
+      } else {
+        std::memcpy(out, pattern.data() + at, next + 1 - at);
+        out += next + 1 - at;
+      }
+      at = next + 1;
+    }
+
+    pattern.remove_prefix(at);
+    return static_cast<size_t>(out - begin);
+  }
+
+  // The positions of the fraction digits of a rendered time, so that they
+  // can be replaced without rendering the rest again.
+  struct FractionFields {
+    constexpr static unsigned capacity = 4;
+    unsigned count;
+    unsigned short at[capacity];
+    unsigned char digits[capacity];
+  };
+
+  // Renders a time point. The fraction fields are recorded relative to
+  // `base` and written with the given nanoseconds.
+  inline auto time_conversion(const CivilTime& time, uint32_t nanoseconds,
+    const char* base, FractionFields& fractions)
+  {
+    return [&time, nanoseconds, base, &fractions](char conversion, unsigned digits, char* out) -> char* {
+      switch(conversion) {
+      case 'Y': return write_year(out, time.year);
+      case 'y': return write_2digits(out, static_cast<unsigned>((time.year % 100 + 100) % 100));
+      case 'm': return write_2digits(out, time.month);
+      case 'd': return write_2digits(out, time.day);
+      case 'j': return write_fixed_digits(out, time.day_of_year, 3);
+      case 'H': return write_2digits(out, time.hour);
+      case 'M': return write_2digits(out, time.minute);
+      case 'S': return write_2digits(out, time.second);
+      case 'F':
+        out = write_year(out, time.year);
+        *out++ = '-';
+        out = write_2digits(out, time.month);
+        *out++ = '-';
+        return write_2digits(out, time.day);
+      case 'T':
+        out = write_2digits(out, time.hour);
+        *out++ = ':';
+        out = write_2digits(out, time.minute);
+        *out++ = ':';
+        return write_2digits(out, time.second);
+      case 'f':
+        digits = digits ? digits : 6;
+        if(base && fractions.count < FractionFields::capacity) {
+          fractions.at[fractions.count] = static_cast<unsigned short>(out - base);
+          fractions.digits[fractions.count] = static_cast<unsigned char>(digits);
+        }
+        fractions.count++;
+        return write_fraction(out, nanoseconds, digits);
+      case 'z': std::memcpy(out, "+0000", 5); return out + 5;
+      case 'Z': std::memcpy(out, "UTC", 3); return out + 3;
+      case '%': *out = '%'; return out + 1;
+      default: return nullptr;
+      }
+    };
+  }
+
+  // Space for any pattern that is cached, at most 24 characters for each
+  // conversion of two or three pattern characters.
+  constexpr size_t max_cached_pattern = 48;
+  constexpr size_t time_buffer_size = 12*max_cached_pattern;
+
+  // The rendered pattern of the latest second, per thread. Most lines of a
+  // log are written within the same second as the one before, only the
+  // fraction digits have to be written for them. The pattern is identified by
+  // its address, which is in the format string.
+  struct TimestampCache {
+    const char* pattern;
+    size_t pattern_length;
+    int64_t second;
+    size_t length;
+    FractionFields fractions;
+    char text[time_buffer_size];
+  };
+
+  inline TimestampCache& timestamp_cache() {
+    thread_local TimestampCache cache = {};
+    return cache;
+  }
+
+  // Patterns that are not cached, rendered in pieces after the prefix. With
+  // a width, the length is determined in a first pass.
+  template<typename Convert, typename Formatter>
+  void append_pattern(std::string_view pattern, Formatter& formatter, Convert&& convert,
+    std::string_view prefix = {})
+  {
+    char buffer[time_buffer_size];
+    size_t length = prefix.size();
+    if(formatter.format().has_width) {
+      for(auto rest = pattern; !rest.empty();)
+        length += expand_pattern(rest, buffer, sizeof(buffer), convert);
+      formatter.append_fill_before(length, Alignment::Left);
+    }
+
+    if(!prefix.empty())
+      formatter.append(prefix);
+    for(auto rest = pattern; !rest.empty();) {
+      const size_t piece = expand_pattern(rest, buffer, sizeof(buffer), convert);
+      formatter.append(std::string_view{buffer, piece});
+    }
+
+    if(formatter.format().has_width)
+      formatter.append_fill_after(length, Alignment::Left);
+  }
+
+  template<typename Formatter>
+  FormattingResult format_time(int64_t seconds, uint32_t nanoseconds,
+    std::string_view pattern, Formatter& formatter)
+  {
+    const auto uncached = [&] {
+      FractionFields ignored = {};
+      const auto time = civil_from_seconds(seconds);
+      append_pattern(pattern, formatter, time_conversion(time, nanoseconds, nullptr, ignored));
+      return FormattingResult::Success;
+    };
+    if(pattern.size() > max_cached_pattern)
+      return uncached();
+
+    auto& cache = timestamp_cache();
+    if(cache.pattern != pattern.data() || cache.pattern_length != pattern.size()
+      || cache.second != seconds)
+    {
+      const auto time = civil_from_seconds(seconds);
+      auto rest = pattern;
+      cache.fractions = {};
+      cache.length = expand_pattern(rest, cache.text, sizeof(cache.text),
+        time_conversion(time, 0, cache.text, cache.fractions));
+      cache.pattern = pattern.data();
+      cache.pattern_length = pattern.size();
+      cache.second = seconds;
+    }
+
+    // Not all fraction fields could be recorded to be replaced
+    if(cache.fractions.count > FractionFields::capacity)
+      return uncached();
+
+    char buffer[time_buffer_size];
+    char* result_buffer = formatter.show_buf(formatter.padded_size(cache.length));
+    char* const start = result_buffer ? result_buffer : buffer;
+
+    std::memcpy(start, cache.text, cache.length);
+    for(unsigned i = 0; i < cache.fractions.count; i++)
+      write_fraction(start + cache.fractions.at[i], nanoseconds, cache.fractions.digits[i]);
+
+    if(start == buffer)
+      formatter.append_padded(std::string_view{buffer, cache.length}, Alignment::Left);
+    else
+      formatter.put_padded(start, cache.length, Alignment::Left);
+    return FormattingResult::Success;
+  }
+
+  // The default pattern shows as many fraction digits as the duration has.
+  template<typename Period>
+  constexpr std::string_view default_time_pattern() {
+    if constexpr(Period::den == 1) return "%F %T";
+    else if constexpr(Period::den <= 1000) return "%F %T.%3f";
+    else if constexpr(Period::den <= 1000000) return "%F %T.%6f";
+    else return "%F %T.%9f";
+  }
+
+  template<typename Period>
+  constexpr std::string_view duration_unit() {
+    if constexpr(std::is_same_v<Period, std::nano>) return "ns";
+    else if constexpr(std::is_same_v<Period, std::micro>) return "us";
+    else if constexpr(std::is_same_v<Period, std::milli>) return "ms";
+    else if constexpr(std::is_same_v<Period, std::ratio<1>>) return "s";
+    else if constexpr(std::is_same_v<Period, std::ratio<60>>) return "min";
+    else if constexpr(std::is_same_v<Period, std::ratio<3600>>) return "h";
+    else if constexpr(std::is_same_v<Period, std::ratio<86400>>) return "d";
+    else return "[?]s";
+  }
+
+  struct DurationFields {
+    bool negative;
+    uint64_t count /* absolute */;
+    uint64_t hours;
+    unsigned minute, second;
+    uint32_t nanoseconds;
+    std::string_view unit;
+  };
+
+  template<typename Rep, typename Period>
+  DurationFields duration_fields(std::chrono::duration<Rep, Period> value) {
+    using namespace std::chrono;
+    DurationFields fields = {};
+    fields.negative = value < value.zero();
+    // Negated in unsigned arithmetic, such that the minimum does not overflow
+    const uint64_t count = static_cast<uint64_t>(value.count());
+    const duration<uint64_t, Period> absolute{fields.negative ? 0 - count : count};
+    const auto whole = duration_cast<duration<uint64_t>>(absolute);
+    const uint64_t total = whole.count();
+
+    fields.count = absolute.count();
+    fields.hours = total / 3600;
+    fields.minute = static_cast<unsigned>(total / 60 % 60);
+    fields.second = static_cast<unsigned>(total % 60);
+    fields.nanoseconds = static_cast<uint32_t>(duration_cast<nanoseconds>(absolute - whole).count());
+    fields.unit = duration_unit<Period>();
+    return fields;
+  }
+
+  inline auto duration_conversion(const DurationFields& fields) {
+    return [&fields](char conversion, unsigned digits, char* out) -> char* {
+      switch(conversion) {
+      case 'H': return write_fixed_digits(out, fields.hours, std::max(count_digits(fields.hours), 2u));
+      case 'M': return write_2digits(out, fields.minute);
+      case 'S': return write_2digits(out, fields.second);
+      case 'f': return write_fraction(out, fields.nanoseconds, digits ? digits : 6);
+      case 'Q': return write_digits(out, fields.count);
+      case 'q':
+        std::memcpy(out, fields.unit.data(), fields.unit.size());
+        return out + fields.unit.size();
+      case '%': *out = '%'; return out + 1;
+      default: return nullptr;
+      }
+    };
+  }
+}
+
+namespace mould {
+  /* Standard implementation for time points of the system clock */
+  template<typename Duration, typename Choice>
+  constexpr auto format_auto(const std::chrono::time_point<std::chrono::system_clock, Duration>&, Choice choice)
+  -> std::enable_if_t<std::is_integral_v<typename Duration::rep>, AutoFormatting<AutoFormattingChoice::string>> {
+    return AutoFormatting<AutoFormattingChoice::string> { };
+  }
+
+  template<typename Duration, typename Formatter>
+  auto format_string(const std::chrono::time_point<std::chrono::system_clock, Duration>& value, Formatter formatter)
+  -> std::enable_if_t<std::is_integral_v<typename Duration::rep>, FormattingResult> {
+    using namespace std::chrono;
+    const auto since_epoch = value.time_since_epoch();
+    const auto whole = floor<seconds>(since_epoch);
+    const auto nanos = duration_cast<nanoseconds>(since_epoch - whole).count();
+
+    auto pattern = formatter.format().extension;
+    if(pattern.empty())
+      pattern = internal::default_time_pattern<typename Duration::period>();
+    return internal::format_time(whole.count(), static_cast<uint32_t>(nanos), pattern, formatter);
+  }
+
+  /* Standard implementation for durations, `1500ms` without a pattern */
+  template<typename Rep, typename Period, typename Choice>
+  constexpr auto format_auto(const std::chrono::duration<Rep, Period>&, Choice choice)
+  -> std::enable_if_t<std::is_integral_v<Rep>, AutoFormatting<AutoFormattingChoice::string>> {
+    return AutoFormatting<AutoFormattingChoice::string> { };
+  }
+
+  template<typename Rep, typename Period, typename Formatter>
+  auto format_string(const std::chrono::duration<Rep, Period>& value, Formatter formatter)
+  -> std::enable_if_t<std::is_integral_v<Rep>, FormattingResult> {
+    const auto fields = internal::duration_fields(value);
+    auto pattern = formatter.format().extension;
+    if(pattern.empty())
+      pattern = "%Q%q";
+
+    internal::append_pattern(pattern, formatter, internal::duration_conversion(fields),
+      fields.negative ? "-" : "");
+    return FormattingResult::Success;
+  }
+}
+
+#endif
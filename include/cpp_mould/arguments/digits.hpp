@@ -0,0 +1,148 @@
+#ifndef CPP_MOULD_ARGUMENTS_DIGITS_HPP
+#define CPP_MOULD_ARGUMENTS_DIGITS_HPP
+/* Digit kernels shared by the integer based formats. Two digits are written
+ * per division, looked up from a table of all pairs. Also the common frame
+ * of numbers with a bounded width.
+ */
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#include "../format.hpp"
+#include "../simd.hpp"
+
+namespace mould::internal {
+  constexpr char digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+  inline char* write_2digits(char* out, unsigned value) {
+    std::memcpy(out, digit_pairs + 2*value, 2);
+    return out + 2;
+  }
+
+  // Exactly `count` digits, zero padded in front. Returns the end.
+  inline char* write_fixed_digits(char* out, uint64_t value, unsigned count) {
+    char* const end = out + count;
+    char* it = end;
+    for(; count >= 2; count -= 2) {
+      it -= 2;
+      std::memcpy(it, digit_pairs + 2*(value % 100), 2);
+      value /= 100;
+    }
+    if(count)
+      *--it = static_cast<char>('0' + value % 10);
+    return end;
+  }
+
+  constexpr uint64_t powers_of_10[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+    100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,
+    10000000000000ull, 100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+    100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull,
+  };
+
+  // Estimated from the bit length as floor(bits*log10(2)), which is at most
+  // one too small, and corrected with one comparison.
+  constexpr unsigned count_digits(uint64_t value) {
+    const unsigned bits = 64 - std::countl_zero(value | 1);
+    const unsigned estimate = (bits*1233) >> 12;
+    return estimate + ((value | 1) >= powers_of_10[estimate] ? 1 : 0);
+  }
+
+  // All digits of the value, without padding. Returns the end.
+  inline char* write_digits(char* out, uint64_t value) {
+    return write_fixed_digits(out, value, count_digits(value));
+  }
+
+  constexpr unsigned grouped_length(unsigned digits) {
+    return digits + (digits - 1)/3;
+  }
+
+  // The `digits` digits of the value with a separator between groups of
+  // three, written right to left in one pass. Returns the end.
+  inline char* write_grouped_digits(char* out, uint64_t value, unsigned digits, char separator) {
+    char* const end = out + grouped_length(digits);
+    char* it = end;
+    for(; digits > 3; digits -= 3) {
+      const unsigned group = value % 1000;
+      value /= 1000;
+      it -= 3;
+      it[0] = static_cast<char>('0' + group/100);
+      std::memcpy(it + 1, digit_pairs + 2*(group % 100), 2);
+      *--it = separator;
+    }
+    write_fixed_digits(it - digits, value, digits);
+    return end;
+  }
+
+  // Exactly `count` hex digits, zero padded in front. Returns the end.
+  inline char* write_hex_digits(char* out, uint64_t value, unsigned count, bool upper) {
+    const char* const digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char* const end = out + count;
+    for(char* it = end; it != out; value >>= 4)
+      *--it = digits[value & 0xF];
+    return end;
+  }
+
+  constexpr unsigned count_hex_digits(uint64_t value) {
+    return (67 - std::countl_zero(value | 1))/4;
+  }
+
+  template<typename T>
+  constexpr uint64_t magnitude(T value) {
+    using U = std::make_unsigned_t<T>;
+    // Negated in unsigned arithmetic, such that the minimum does not overflow
+    return (value < 0) ? static_cast<U>(~static_cast<U>(value) + U{1}) : static_cast<U>(value);
+  }
+
+#if defined(__SSE2__)
+  // The 8 digits of a value below 10^8 in 16 bit lanes, by multiplications
+  // only (W. Mula, SSE2 itoa): split into two halves of 4 digits, then each
+  // half is divided by 1000, 100, 10 and 1 at once and the tens subtracted.
+  inline __m128i decimal_lanes(uint32_t value) {
+    const __m128i whole = _mm_cvtsi32_si128(static_cast<int>(value));
+    const __m128i high = _mm_srli_epi64(_mm_mul_epu32(whole, _mm_set1_epi32(static_cast<int>(0xd1b71759))), 45);
+    const __m128i low = _mm_sub_epi32(whole, _mm_mul_epu32(high, _mm_set1_epi32(10000)));
+    const __m128i halves = _mm_slli_epi64(_mm_unpacklo_epi16(high, low), 2);
+    const __m128i spread = _mm_unpacklo_epi32(_mm_unpacklo_epi16(halves, halves), _mm_unpacklo_epi16(halves, halves));
+    const __m128i divided = _mm_mulhi_epu16(
+      _mm_mulhi_epu16(spread, _mm_setr_epi16(8389, 5243, 13108, -32768, 8389, 5243, 13108, -32768)),
+      _mm_setr_epi16(1 << 7, 1 << 11, 1 << 13, -32768, 1 << 7, 1 << 11, 1 << 13, -32768));
+    const __m128i tens = _mm_slli_epi64(_mm_mullo_epi16(divided, _mm_set1_epi16(10)), 16);
+    return _mm_sub_epi16(divided, tens);
+  }
+
+  // 16 characters, the 8 digits of `high` then those of `low`, both below 10^8
+  inline __m128i decimal_digits16(uint32_t high, uint32_t low) {
+    return _mm_add_epi8(_mm_packus_epi16(decimal_lanes(high), decimal_lanes(low)), _mm_set1_epi8('0'));
+  }
+#endif
+
+  // Writes the sign and a number of at most `max_width` characters with the
+  // padding of numbers.
+  template<size_t max_width, typename Formatter, typename Write>
+  void format_bounded_number(Formatter& formatter, bool negative, Write&& write) {
+    char buffer[max_width];
+    char* result_buffer = formatter.show_buf(formatter.padded_size(max_width));
+    char* const start = result_buffer ? result_buffer : buffer;
+    char* out = start;
+
+    if(negative) *out++ = '-';
+    else if(formatter.format().sign == Sign::Always) *out++ = '+';
+    else if(formatter.format().sign == Sign::Pad) *out++ = ' ';
+
+    const size_t sign_length = out - start;
+    const size_t length = write(out) - start;
+
+    if(start == buffer)
+      formatter.append_padded(std::string_view{buffer, length}, Alignment::Right, sign_length);
+    else
+      formatter.put_padded(start, length, Alignment::Right, sign_length);
+  }
+}
+
+#endif
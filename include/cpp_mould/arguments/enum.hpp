@@ -0,0 +1,161 @@
+#ifndef CPP_MOULD_ARGUMENTS_ENUM_HPP
+#define CPP_MOULD_ARGUMENTS_ENUM_HPP
+/* Enumerations with a table of names, and bool. */
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+#include "../argument.hpp"
+#include "digits.hpp"
+
+namespace mould {
+  // Specialize to make an enumeration formattable by name:
+  //
+  //   template<> struct mould::EnumNames<Color> {
+  //     static constexpr std::string_view names[] = { "red", "green", "blue" };
+  //   };
+  //
+  // The name of a value is at the index of its underlying value, values
+  // outside of the table are written as numbers.
+  template<typename E>
+  struct EnumNames;
+}
+
+namespace mould::internal {
+  template<typename E, typename = void>
+  constexpr bool has_enum_names = false;
+
+  template<typename E>
+  constexpr bool has_enum_names<E, std::void_t<decltype(EnumNames<E>::names)>>
+    = std::is_enum_v<E>;
+
+  // All names in one blob, the name of index `i` is between `offsets[i]` and
+  // `offsets[i + 1]`. Built at compile time.
+  template<size_t Count, size_t Length>
+  struct NameBlob {
+    char text[Length + 1];
+    uint32_t offsets[Count + 1];
+
+    constexpr std::string_view operator[](size_t index) const {
+      return { text + offsets[index], offsets[index + 1] - offsets[index] };
+    }
+  };
+
+  template<size_t Length, size_t Count>
+  constexpr auto make_name_blob(const std::string_view (&names)[Count]) {
+    NameBlob<Count, Length> blob = {};
+    uint32_t at = 0;
+    for(size_t i = 0; i < Count; i++) {
+      blob.offsets[i] = at;
+      for(char chr : names[i]) blob.text[at++] = chr;
+    }
+    blob.offsets[Count] = at;
+    return blob;
+  }
+
+  template<size_t Count>
+  constexpr size_t total_length(const std::string_view (&names)[Count]) {
+    size_t length = 0;
+    for(auto name : names) length += name.size();
+    return length;
+  }
+
+  template<size_t Count>
+  constexpr size_t longest(const std::string_view (&names)[Count]) {
+    size_t length = 0;
+    for(auto name : names) length = std::max(length, name.size());
+    return length;
+  }
+
+  template<typename E>
+  struct EnumTable {
+    using Underlying = std::underlying_type_t<E>;
+    constexpr static auto& names = EnumNames<E>::names;
+    constexpr static size_t count = std::size(names);
+    constexpr static auto blob = make_name_blob<total_length(names)>(names);
+
+    // Values without a name are written as number
+    constexpr static int number_width = std::numeric_limits<Underlying>::digits10 + 2;
+    constexpr static int max_width = std::max<int>(longest(names), number_width);
+  };
+
+  template<typename E>
+  struct EnumResultInformation {
+    constexpr static int max_width = EnumTable<E>::max_width;
+  };
+
+  // Writes a name or number of at most `max_width` characters with the
+  // padding of text.
+  template<size_t max_width, typename Formatter, typename Write>
+  void format_bounded_text(Formatter& formatter, Write&& write) {
+    char buffer[max_width];
+    char* result_buffer = formatter.show_buf(formatter.padded_size(max_width));
+    char* const start = result_buffer ? result_buffer : buffer;
+    const size_t length = write(start);
+
+    if(start == buffer)
+      formatter.append_padded(std::string_view{buffer, length}, Alignment::Left);
+    else
+      formatter.put_padded(start, length, Alignment::Left);
+  }
+}
+
+namespace mould {
+  /* Standard implementation for enums with EnumNames */
+  template<typename E, typename Choice>
+  constexpr auto format_auto(const E&, Choice choice)
+  -> std::enable_if_t<internal::has_enum_names<E>, AutoFormatting<AutoFormattingChoice::string>> {
+    return AutoFormatting<AutoFormattingChoice::string> { };
+  }
+
+  template<typename E, typename Formatter>
+  auto format_string(const E& value, Formatter formatter)
+  -> std::enable_if_t<internal::has_enum_names<E>, ResultWithInformation<internal::EnumResultInformation<E>>> {
+    using Table = internal::EnumTable<E>;
+    using Underlying = typename Table::Underlying;
+    const auto index = static_cast<Underlying>(value);
+
+    internal::format_bounded_text<Table::max_width>(formatter, [index](char* out) -> size_t {
+      if(index >= 0 && static_cast<std::make_unsigned_t<Underlying>>(index) < Table::count) {
+        const auto name = Table::blob[index];
+        std::memcpy(out, name.data(), name.size());
+        return name.size();
+      }
+
+      char* const start = out;
+      if(index < 0) *out++ = '-';
+      // Negated in unsigned arithmetic, such that the minimum does not overflow
+      const uint64_t magnitude = index < 0 ? 0 - static_cast<uint64_t>(index) : static_cast<uint64_t>(index);
+      return internal::write_digits(out, magnitude) - start;
+    });
+    return FormattingResult::Success;
+  }
+
+  /* Standard implementation for bool */
+  struct BoolResultInformation {
+    constexpr static int max_width = 5;
+  };
+
+  // Templates, such that no other type converts to bool for them
+  template<typename T, typename Choice>
+  constexpr auto format_auto(const T&, Choice choice)
+  -> std::enable_if_t<std::is_same_v<T, bool>, AutoFormatting<AutoFormattingChoice::string>> {
+    return AutoFormatting<AutoFormattingChoice::string> { };
+  }
+
+  template<typename T, typename Formatter>
+  auto format_string(const T& value, Formatter formatter)
+  -> std::enable_if_t<std::is_same_v<T, bool>, ResultWithInformation<BoolResultInformation>> {
+    internal::format_bounded_text<BoolResultInformation::max_width>(formatter, [value](char* out) -> size_t {
+      std::memcpy(out, value ? "true" : "false", 5);
+      return value ? 4 : 5;
+    });
+    return FormattingResult::Success;
+  }
+}
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef CPP_MOULD_ARGUMENTS_ESCAPE_HPP
+#define CPP_MOULD_ARGUMENTS_ESCAPE_HPP
+/* Quoted strings with escapes, as JSON string or as C string literal. */
+#include <cstring>
+#include <string_view>
+
+#include "../format.hpp"
+#include "../simd.hpp"
+
+namespace mould::internal {
+  enum struct EscapeStyle {
+    Json /* \" \\ \n etc. and \u00XX for other control characters */,
+    C    /* \" \\ \n etc. and octal \ooo for other control characters */,
+  };
+
+  // The longest escape sequence of a single byte
+  constexpr size_t max_escape_length = 6;
+
+  // Characters that can not appear verbatim. Bytes above 0x7F are kept, so
+  // that UTF-8 passes through unchanged.
+  template<EscapeStyle style>
+  constexpr bool needs_escape(unsigned char chr) {
+    return chr < 0x20 || chr == '"' || chr == '\\'
+      || (style == EscapeStyle::C && chr == 0x7F);
+  }
+
+#ifdef CPP_MOULD_SIMD_BLOCK
+  template<EscapeStyle style>
+  inline uint32_t escape_mask(const simd::Block& block) {
+    uint32_t mask = block.at_most(0x1F) | block.equal('"') | block.equal('\\');
+    if constexpr(style == EscapeStyle::C)
+      mask |= block.equal('\x7F');
+    return mask;
+  }
+#endif
+
+  // The number of leading characters that are copied verbatim.
+  template<EscapeStyle style>
+  inline size_t clean_run(const char* begin, const char* end) {
+    const char* it = begin;
+#ifdef CPP_MOULD_SIMD_BLOCK
+    using simd::Block;
+    for(; static_cast<size_t>(end - it) >= Block::size; it += Block::size) {
+      if(const auto mask = escape_mask<style>(Block::load(it)))
+        return static_cast<size_t>(it - begin) + simd::trailing_zeros(mask);
+    }
+#endif
+    while(it != end && !needs_escape<style>(*it)) it++;
+    return static_cast<size_t>(it - begin);
+  }
+
+  // Writes the escape sequence of a character that needs one.
+  template<EscapeStyle style>
+  inline size_t escape_char(unsigned char chr, char* out) {
+    char short_form = 0;
+    switch(chr) {
+    case '"': short_form = '"'; break;
+    case '\\': short_form = '\\'; break;
+    case '\b': short_form = 'b'; break;
+    case '\f': short_form = 'f'; break;
+    case '\n': short_form = 'n'; break;
+    case '\r': short_form = 'r'; break;
+    case '\t': short_form = 't'; break;
+    case '\a': short_form = style == EscapeStyle::C ? 'a' : 0; break;
+    case '\v': short_form = style == EscapeStyle::C ? 'v' : 0; break;
+    }
+
+    out[0] = '\\';
+    if(short_form) {
+      out[1] = short_form;
+      return 2;
+    }
+
+    if constexpr(style == EscapeStyle::Json) {
+      constexpr char digits[] = "0123456789abcdef";
+      std::memcpy(out + 1, "u00", 3);
+      out[4] = digits[chr >> 4];
+      out[5] = digits[chr & 0xF];
+      return 6;
+    } else {
+      // Always three digits, a following digit can not extend the escape
+      out[1] = static_cast<char>('0' + (chr >> 6));
+      out[2] = static_cast<char>('0' + ((chr >> 3) & 0x7));
+      out[3] = static_cast<char>('0' + (chr & 0x7));
+      return 4;
+    }
+  }
+
+  // Length of the quoted and escaped string.
+  template<EscapeStyle style>
+  inline size_t escaped_length(std::string_view value) {
+    size_t length = 2;
+    char scratch[max_escape_length];
+    for(const char* it = value.data(), *end = it + value.size(); it != end;) {
+      const size_t run = clean_run<style>(it, end);
+      length += run;
+      it += run;
+      if(it != end)
+        length += escape_char<style>(*it++, scratch);
+    }
+    return length;
+  }
+
+  // Escapes into a buffer of at least `2 + max_escape_length*value.size()`
+  // characters, returns the written length.
+  template<EscapeStyle style>
+  inline size_t escape_into(std::string_view value, char* buffer) {
+    char* out = buffer;
+    *out++ = '"';
+    for(const char* it = value.data(), *end = it + value.size(); it != end;) {
+      const size_t run = clean_run<style>(it, end);
+      std::memcpy(out, it, run);
+      out += run;
+      it += run;
+      if(it != end)
+        out += escape_char<style>(*it++, out);
+    }
+    *out++ = '"';
+    return static_cast<size_t>(out - buffer);
+  }
+
+  // Appends the escaped string in pieces, clean runs are copied in bulk.
+  template<EscapeStyle style, typename Formatter>
+  void append_escaped(std::string_view value, Formatter& formatter) {
+    char escape[max_escape_length];
+    formatter.append('"');
+    for(const char* it = value.data(), *end = it + value.size(); it != end;) {
+      const size_t run = clean_run<style>(it, end);
+      if(run)
+        formatter.append(std::string_view{it, run});
+      it += run;
+      if(it != end)
+        formatter.append(std::string_view{escape, escape_char<style>(*it++, escape)});
+    }
+    formatter.append('"');
+  }
+
+  // The precision limits the characters taken from the string, the width
+  // applies to the quoted result. Nothing is escaped into a temporary: the
+  // output goes straight to the engine buffer or is appended in pieces.
+  template<EscapeStyle style, typename Formatter>
+  FormattingResult format_escaped(std::string_view value, Formatter& formatter) {
+    const auto& format = formatter.format();
+    if(format.has_precision && format.precision < value.size())
+      value = value.substr(0, format.precision);
+
+    const size_t worst_case = 2 + max_escape_length*value.size();
+    if(char* buffer = formatter.show_buf(formatter.padded_size(worst_case))) {
+      formatter.put_padded(buffer, escape_into<style>(value, buffer), Alignment::Left);
+    } else if(format.has_width) {
+      const size_t length = escaped_length<style>(value);
+      formatter.append_fill_before(length, Alignment::Left);
+      append_escaped<style>(value, formatter);
+      formatter.append_fill_after(length, Alignment::Left);
+    } else {
+      append_escaped<style>(value, formatter);
+    }
+    return FormattingResult::Success;
+  }
+}
+
+#endif
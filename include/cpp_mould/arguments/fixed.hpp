@@ -0,0 +1,93 @@
+#ifndef CPP_MOULD_ARGUMENTS_FIXED_HPP
+#define CPP_MOULD_ARGUMENTS_FIXED_HPP
+/* Decimals stored as integers scaled by a power of ten. */
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "../argument.hpp"
+#include "../format.hpp"
+#include "digits.hpp"
+#include "human.hpp"
+
+namespace mould {
+  // The value `value / 10^Scale`, formatted with integer arithmetic only.
+  template<unsigned Scale>
+  struct FixedPoint {
+    static_assert(Scale <= 18, "The scale of a 64 bit fixed point value is at most 18");
+    int64_t value;
+  };
+
+  template<unsigned Scale>
+  constexpr FixedPoint<Scale> fixed(int64_t value) {
+    return { value };
+  }
+}
+
+namespace mould::internal {
+  // The largest precision of FixedPoint, a larger one is an error
+  constexpr unsigned max_fixed_precision = 64;
+
+  // Sign, 19 digits with group separators, the point and the fraction
+  constexpr size_t fixed_max_width = 1 + 19 + 6 + 1 + max_fixed_precision;
+
+  // Rounds `magnitude / 10^scale` to `precision` fraction digits, halfway
+  // cases to even, and writes it. Fraction digits beyond the scale are 0.
+  inline char* write_fixed_point(char* out, uint64_t magnitude, unsigned scale,
+      unsigned precision, char separator) {
+    const unsigned kept = std::min(precision, scale);
+    if(kept < scale) {
+      const uint64_t divisor = powers_of_10[scale - kept];
+      const uint64_t remainder = magnitude % divisor;
+      magnitude /= divisor;
+      if(remainder > divisor/2 || (remainder == divisor/2 && (magnitude & 1)))
+        magnitude++;
+    }
+
+    const uint64_t whole = magnitude/powers_of_10[kept];
+    const unsigned digits = count_digits(whole);
+    out = separator
+      ? write_grouped_digits(out, whole, digits, separator)
+      : write_fixed_digits(out, whole, digits);
+
+    if(precision) {
+      *out++ = '.';
+      out = write_fixed_digits(out, magnitude % powers_of_10[kept], kept);
+      std::memset(out, '0', precision - kept);
+      out += precision - kept;
+    }
+    return out;
+  }
+}
+
+namespace mould {
+  /* Standard implementation for FixedPoint, `{}` shows all digits of the
+   * scale, `{:.2f}` rounds to two of them. A precision above 64 is an error.
+   */
+  template<unsigned Scale, typename Choice>
+  constexpr AutoFormatting<AutoFormattingChoice::fpoint> format_auto(const FixedPoint<Scale>&, Choice choice) {
+    return AutoFormatting<AutoFormattingChoice::fpoint> { };
+  }
+
+  struct FixedResultInformation {
+    constexpr static int max_width = internal::fixed_max_width;
+  };
+
+  template<unsigned Scale, typename Formatter>
+  ResultWithInformation<FixedResultInformation> format_fpoint(const FixedPoint<Scale>& value, Formatter formatter) {
+    const auto& format = formatter.format();
+    if(format.has_precision && format.precision > internal::max_fixed_precision)
+      return FormattingResult::Error;
+    const unsigned precision = format.has_precision ? static_cast<unsigned>(format.precision) : Scale;
+    const char separator = format.grouping;
+
+    internal::format_bounded_number<internal::fixed_max_width>(formatter, value.value < 0,
+      [&value, precision, separator](char* out) {
+        return internal::write_fixed_point(out, internal::magnitude(value.value), Scale,
+          precision, separator);
+      });
+    return FormattingResult::Success;
+  }
+}
+
+#endif
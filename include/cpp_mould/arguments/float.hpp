@@ -1,79 +1,225 @@
 #ifndef CPP_MOULD_ARGUMENTS_FLOAT_HPP
 #define CPP_MOULD_ARGUMENTS_FLOAT_HPP
 #include <algorithm>
+#include <cctype>
+#include <cmath>
 #include <cstdio>
-
-#include <double-conversion/double-conversion.h>
-#include <ryu/ryu.h>
-#include <dragonbox.h>
+#include <cstring>
 
 #include "../format.hpp"
+#include "float_backend.hpp"
 
-namespace mould {
-  /* Standard implementation for double */
-  template<typename Choice>
-  constexpr AutoFormatting<AutoFormattingChoice::string> format_auto(double, Choice choice) {
-    return AutoFormatting<AutoFormattingChoice::string> { };
-  }
+namespace mould::internal {
+  // The largest precision of the float kinds, a larger one is an error. It
+  // is as large as the backend can write, see "float_backend.hpp".
+  constexpr unsigned max_double_precision = FixedFloatBackend::max_precision;
 
-  struct DoubleResultInformation { };
+  // With a separator after every three of the up to 309 integer digits
+  constexpr size_t grouped_double_buffer_size(unsigned precision = 0) {
+    return double_buffer_size(precision) + 128;
+  }
 
-  template<typename Formatter>
-  ResultWithInformation<DoubleResultInformation> format_string(double value, Formatter formatter) {
-    using namespace double_conversion;
-    char buffer[100];
+  // The common frame of all double formats: the sign, the choice of buffer
+  // and the padding. `write` puts the digits of the value into the buffer,
+  // which has at least `reserve` bytes.
+  template<typename Formatter, typename Write>
+  FormattingResult format_double(double value, Formatter& formatter, Write&& write,
+      size_t reserve = double_buffer_size()) {
+    char buffer[grouped_double_buffer_size(max_double_precision)];
 
     auto format = formatter.format();
-    char* result_buffer = formatter.show_buf(100);
+    char* result_buffer = formatter.show_buf(formatter.padded_size(reserve));
     result_buffer = result_buffer ? result_buffer : buffer;
     const auto start = result_buffer;
 
-    if(format.sign == internal::Sign::Always && value >= 0)
+    if(format.sign == internal::Sign::Always && !std::signbit(value))
       *result_buffer++ = '+'; // Add the sign
-    else if(format.sign == internal::Sign::Pad && value >= 0)
+    else if(format.sign == internal::Sign::Pad && !std::signbit(value))
       *result_buffer++ = ' '; // Add the sign
 
-    result_buffer = dragonbox::Dtoa(result_buffer, value);
+    result_buffer = write(result_buffer);
     const size_t length = result_buffer - start;
+    const size_t sign_length = (*start == '+' || *start == '-' || *start == ' ') ? 1 : 0;
 
     if (start == buffer) {
       const auto important_buffer = std::string_view{start, length};
-      formatter.append(important_buffer);
+      formatter.append_padded(important_buffer, Alignment::Right, sign_length);
     } else {
-      formatter.put_buf(length);
+      formatter.put_padded(start, length, Alignment::Right, sign_length);
     }
 
     return FormattingResult::Success;
   }
 
-  template<typename Formatter>
-  ResultWithInformation<DoubleResultInformation> format_fpoint(double value, Formatter formatter) {
-    using namespace double_conversion;
-    char buffer[100];
+  // Rewrites the output of `%.*e` for a finite value, holding `precision`
+  // significant digits, in place into the notation chosen by `%g`. The
+  // digits are generated only once, the decimal exponent is read back from
+  // the text. Returns the new end of the number, the buffer needs some slack
+  // for the leading zeros.
+  inline char* general_from_exponent(char* begin, char* end, int precision, bool upper) {
+    char* const digits = (*begin == '-') ? begin + 1 : begin;
+    char* const exp_begin = std::find(digits, end, 'e');
+
+    int exponent = 0;
+    for(const char* it = exp_begin + 2; it != end; it++)
+      exponent = exponent*10 + (*it - '0');
+    if(exp_begin[1] == '-')
+      exponent = -exponent;
+
+    const bool has_point = (exp_begin - digits) > 1;
+    const int fraction_length = has_point ? static_cast<int>(exp_begin - digits) - 2 : 0;
+
+    if(exponent < -4 || exponent >= precision) {
+      char* mantissa_end = exp_begin;
+      if(has_point) {
+        while(mantissa_end[-1] == '0') mantissa_end--;
+        if(mantissa_end[-1] == '.') mantissa_end--;
+      }
+      const auto exp_length = end - exp_begin;
+      std::memmove(mantissa_end, exp_begin, exp_length);
+      *mantissa_end = upper ? 'E' : 'e';
+      return mantissa_end + exp_length;
+    }
 
-    auto format = formatter.format();
-    char* result_buffer = formatter.show_buf(100);
-    result_buffer = result_buffer ? result_buffer : buffer;
-    const auto start = result_buffer;
+    char* fixed_end;
+    if(exponent >= 0) {
+      // d.ddddd -> ddd.dd, there are always at least `exponent` fraction digits
+      std::memmove(digits + 1, digits + 2, exponent);
+      if(exponent < fraction_length) digits[exponent + 1] = '.';
+      fixed_end = exp_begin;
+      if(exponent == fraction_length) fixed_end -= has_point ? 1 : 0;
+    } else {
+      // d.ddddd -> 0.000dddddd
+      const int shift = 1 - exponent;
+      if(has_point) std::memmove(digits + 1, digits + 2, fraction_length);
+      std::memmove(digits + shift, digits, fraction_length + 1);
+      std::fill(digits, digits + shift, '0');
+      digits[1] = '.';
+      fixed_end = digits + shift + fraction_length + 1;
+    }
 
-    if(format.sign == internal::Sign::Always && value >= 0)
-      *result_buffer++ = '+'; // Add the sign
-    else if(format.sign == internal::Sign::Pad && value >= 0)
-      *result_buffer++ = ' '; // Add the sign
+    if(std::find(digits, fixed_end, '.') != fixed_end) {
+      while(fixed_end[-1] == '0') fixed_end--;
+      if(fixed_end[-1] == '.') fixed_end--;
+    }
 
-    unsigned fixed_count = format.has_precision ? format.precision : 6;
+    return fixed_end;
+  }
 
-    int written = d2fixed_buffered_n(value, fixed_count, result_buffer);
-    const size_t length = static_cast<size_t>((result_buffer + written) - start);
+  // Inserts separators into the integer digits of a fixed notation number in
+  // place. The fraction is moved once, then the integer digits are copied
+  // right to left with the separators. Returns the new end.
+  inline char* group_fixed_digits(char* begin, char* end, char separator) {
+    char* const digits = (*begin == '-') ? begin + 1 : begin;
+    char* const integer_end = std::find(digits, end, '.');
+    if(digits == integer_end || !std::isdigit(static_cast<unsigned char>(*digits)))
+      return end; // Special values such as inf and nan
+
+    const auto count = integer_end - digits;
+    const auto separators = (count - 1)/3;
+    if(!separators)
+      return end;
+
+    std::memmove(integer_end + separators, integer_end, end - integer_end);
+    char* from = integer_end;
+    char* to = integer_end + separators;
+    for(auto remaining = count; remaining > 3; remaining -= 3) {
+      from -= 3;
+      to -= 3;
+      std::memmove(to, from, 3);
+      *--to = separator;
+    }
+    return end + separators;
+  }
 
-    if (start == buffer) {
-      const auto important_buffer = std::string_view{start, length};
-      formatter.append(important_buffer);
-    } else {
-      formatter.put_buf(length);
+  // The `%g` output of a double. Infinity and NaN are written as by printf,
+  // the backends spell them differently.
+  inline char* write_general(char* buffer, double value, int precision, bool upper) {
+    if(!std::isfinite(value)) {
+      if(std::signbit(value)) *buffer++ = '-';
+      const char* text = std::isnan(value) ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf");
+      std::memcpy(buffer, text, 3);
+      return buffer + 3;
+    }
+    char* end = FixedFloatBackend::exponent(buffer, value, precision - 1);
+    return general_from_exponent(buffer, end, precision, upper);
+  }
+
+  // The precision of the format, above max_double_precision if it is larger
+  inline unsigned double_precision(const Format& format, unsigned fallback) {
+    if(!format.has_precision)
+      return fallback;
+    return static_cast<unsigned>(std::min<Immediate>(format.precision, max_double_precision + 1));
+  }
+}
+
+namespace mould {
+  /* Standard implementation for double */
+  template<typename Choice>
+  constexpr AutoFormatting<AutoFormattingChoice::string> format_auto(double, Choice choice) {
+    return AutoFormatting<AutoFormattingChoice::string> { };
+  }
+
+  struct DoubleResultInformation { };
+
+  template<typename Formatter>
+  ResultWithInformation<DoubleResultInformation> format_string(double value, Formatter formatter) {
+    return internal::format_double(value, formatter, [value](char* buffer) {
+      return internal::ShortestFloatBackend::shortest(buffer, value);
+    });
+  }
+
+  template<typename Formatter>
+  ResultWithInformation<DoubleResultInformation> format_fpoint(double value, Formatter formatter) {
+    const unsigned precision = internal::double_precision(formatter.format(), 6);
+    if(precision > internal::max_double_precision)
+      return FormattingResult::Error;
+    if(const char separator = formatter.format().grouping) {
+      return internal::format_double(value, formatter, [value, precision, separator](char* buffer) {
+        char* end = internal::FixedFloatBackend::fixed(buffer, value, precision);
+        return internal::group_fixed_digits(buffer, end, separator);
+      }, internal::grouped_double_buffer_size(precision));
     }
+    return internal::format_double(value, formatter, [value, precision](char* buffer) {
+      return internal::FixedFloatBackend::fixed(buffer, value, precision);
+    }, internal::double_buffer_size(precision));
+  }
 
-    return FormattingResult::Success;
+  // The digits of a hundred times the value, the scaling is done on the
+  // double and not on the text.
+  template<typename Formatter>
+  ResultWithInformation<DoubleResultInformation> format_percent(double value, Formatter formatter) {
+    const unsigned precision = internal::double_precision(formatter.format(), 6);
+    if(precision > internal::max_double_precision)
+      return FormattingResult::Error;
+    const char separator = formatter.format().grouping;
+    return internal::format_double(value, formatter, [value, precision, separator](char* buffer) {
+      char* end = internal::FixedFloatBackend::fixed(buffer, value*100, precision);
+      if(separator) end = internal::group_fixed_digits(buffer, end, separator);
+      *end++ = '%';
+      return end;
+    }, separator ? internal::grouped_double_buffer_size(precision) : internal::double_buffer_size(precision));
+  }
+
+  template<typename Formatter>
+  ResultWithInformation<DoubleResultInformation> format_general(double value, Formatter formatter) {
+    // A precision of 0 is treated as 1, as in printf
+    const int precision = std::max(internal::double_precision(formatter.format(), 6), 1u);
+    if(precision > static_cast<int>(internal::max_double_precision))
+      return FormattingResult::Error;
+    return internal::format_double(value, formatter, [value, precision](char* buffer) {
+      return internal::write_general(buffer, value, precision, false);
+    }, internal::double_buffer_size(precision));
+  }
+
+  template<typename Formatter>
+  ResultWithInformation<DoubleResultInformation> format_GENERAL(double value, Formatter formatter) {
+    const int precision = std::max(internal::double_precision(formatter.format(), 6), 1u);
+    if(precision > static_cast<int>(internal::max_double_precision))
+      return FormattingResult::Error;
+    return internal::format_double(value, formatter, [value, precision](char* buffer) {
+      return internal::write_general(buffer, value, precision, true);
+    }, internal::double_buffer_size(precision));
   }
 }
 
@@ -0,0 +1,65 @@
+#ifndef CPP_MOULD_ARGUMENTS_FLOAT_BACKEND_HPP
+#define CPP_MOULD_ARGUMENTS_FLOAT_BACKEND_HPP
+/* Compile time selection of the float to string algorithms.
+ *
+ * CPP_MOULD_FLOAT_SHORTEST chooses the algorithm for the shortest round trip
+ * representation (`{}` and `{:s}`), CPP_MOULD_FLOAT_FIXED the one for all
+ * formats with a precision (`{:f}`, `{:g}`), up to its `max_precision`. Only
+ * the selected libraries are included and need to be linked.
+ */
+
+#define CPP_MOULD_FLOAT_RYU 1
+#define CPP_MOULD_FLOAT_DRAGONBOX 2
+#define CPP_MOULD_FLOAT_DOUBLE_CONVERSION 3
+
+#ifndef CPP_MOULD_FLOAT_SHORTEST
+#define CPP_MOULD_FLOAT_SHORTEST CPP_MOULD_FLOAT_DRAGONBOX
+#endif
+
+#ifndef CPP_MOULD_FLOAT_FIXED
+#define CPP_MOULD_FLOAT_FIXED CPP_MOULD_FLOAT_RYU
+#endif
+
+#include "float_backend/buffer.hpp"
+
+#if CPP_MOULD_FLOAT_SHORTEST == CPP_MOULD_FLOAT_RYU || CPP_MOULD_FLOAT_FIXED == CPP_MOULD_FLOAT_RYU
+#include "float_backend/ryu.hpp"
+#endif
+
+#if CPP_MOULD_FLOAT_SHORTEST == CPP_MOULD_FLOAT_DRAGONBOX || CPP_MOULD_FLOAT_FIXED == CPP_MOULD_FLOAT_DRAGONBOX
+#include "float_backend/dragonbox.hpp"
+#endif
+
+#if CPP_MOULD_FLOAT_SHORTEST == CPP_MOULD_FLOAT_DOUBLE_CONVERSION || CPP_MOULD_FLOAT_FIXED == CPP_MOULD_FLOAT_DOUBLE_CONVERSION
+#include "float_backend/double_conversion.hpp"
+#endif
+
+namespace mould::internal {
+  template<int Backend>
+  struct SelectFloatBackend;
+
+#ifdef CPP_MOULD_ARGUMENTS_FLOAT_BACKEND_RYU_HPP
+  template<>
+  struct SelectFloatBackend<CPP_MOULD_FLOAT_RYU> { using type = float_backend::Ryu; };
+#endif
+
+#ifdef CPP_MOULD_ARGUMENTS_FLOAT_BACKEND_DRAGONBOX_HPP
+  template<>
+  struct SelectFloatBackend<CPP_MOULD_FLOAT_DRAGONBOX> { using type = float_backend::Dragonbox; };
+#endif
+
+#ifdef CPP_MOULD_ARGUMENTS_FLOAT_BACKEND_DOUBLE_CONVERSION_HPP
+  template<>
+  struct SelectFloatBackend<CPP_MOULD_FLOAT_DOUBLE_CONVERSION> { using type = float_backend::DoubleConversion; };
+#endif
+
+  using ShortestFloatBackend = typename SelectFloatBackend<CPP_MOULD_FLOAT_SHORTEST>::type;
+  using FixedFloatBackend = typename SelectFloatBackend<CPP_MOULD_FLOAT_FIXED>::type;
+
+  static_assert(ShortestFloatBackend::has_shortest,
+    "CPP_MOULD_FLOAT_SHORTEST selects a library without shortest representation");
+  static_assert(FixedFloatBackend::has_precision,
+    "CPP_MOULD_FLOAT_FIXED selects a library without precision based output");
+}
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef CPP_MOULD_ARGUMENTS_FLOAT_BACKEND_BUFFER_HPP
+#define CPP_MOULD_ARGUMENTS_FLOAT_BACKEND_BUFFER_HPP
+#include <cstddef>
+
+namespace mould::internal {
+  // Space that the float formatters provide for a double in fixed notation
+  // with `precision` fraction digits: a sign, up to 309 integer digits, the
+  // point and some slack for rewriting the digits in place.
+  constexpr size_t double_buffer_size(unsigned precision = 0) {
+    return 384 + precision;
+  }
+}
+
+#endif
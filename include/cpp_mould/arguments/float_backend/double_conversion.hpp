@@ -0,0 +1,83 @@
+#ifndef CPP_MOULD_ARGUMENTS_FLOAT_BACKEND_DOUBLE_CONVERSION_HPP
+#define CPP_MOULD_ARGUMENTS_FLOAT_BACKEND_DOUBLE_CONVERSION_HPP
+#include <cstring>
+#include <double-conversion/double-conversion.h>
+
+#include "buffer.hpp"
+
+namespace mould::float_backend {
+  /* Google's double-conversion. The shortest output follows EcmaScript, the
+   * precision based output matches printf. ToFixed stops at 1e60, larger
+   * values are written from their integer digits.
+   */
+  struct DoubleConversion {
+    static constexpr bool has_shortest = true;
+    static constexpr bool has_precision = true;
+    // The limit of ToFixed, ToExponential takes some more digits
+    static constexpr unsigned max_precision =
+      double_conversion::DoubleToStringConverter::kMaxFixedDigitsAfterPoint;
+
+    // The builder for the space of the formatters, minus a sign. It also
+    // terminates the output with a nul character.
+    static int buffer_size(unsigned precision) {
+      return static_cast<int>(internal::double_buffer_size(precision)) - 1;
+    }
+
+    static const double_conversion::DoubleToStringConverter& printf_converter() {
+      using double_conversion::DoubleToStringConverter;
+      static const DoubleToStringConverter converter {
+        DoubleToStringConverter::EMIT_POSITIVE_EXPONENT_SIGN,
+        "Infinity", "nan", 'e',
+        -6, 21, 6, 0,
+        /* min_exponent_width */ 2
+      };
+      return converter;
+    }
+
+    static char* shortest(char* buffer, double value) {
+      using double_conversion::DoubleToStringConverter;
+      double_conversion::StringBuilder builder { buffer, buffer_size(0) };
+      DoubleToStringConverter::EcmaScriptConverter().ToShortest(value, &builder);
+      return buffer + builder.position();
+    }
+
+    static char* fixed(char* buffer, double value, unsigned precision) {
+      {
+        double_conversion::StringBuilder builder { buffer, buffer_size(precision) };
+        if(printf_converter().ToFixed(value, static_cast<int>(precision), &builder))
+          return buffer + builder.position();
+      }
+      return large_fixed(buffer, value, precision);
+    }
+
+    // Values from 1e60 on, where ToFixed fails, are integers. Their digits
+    // are generated exactly and followed by zeros.
+    static char* large_fixed(char* buffer, double value, unsigned precision) {
+      using double_conversion::DoubleToStringConverter;
+      char digits[internal::double_buffer_size()];
+      bool negative;
+      int length, point;
+      DoubleToStringConverter::DoubleToAscii(value, DoubleToStringConverter::FIXED, 0,
+        digits, sizeof(digits), &negative, &length, &point);
+
+      if(negative) *buffer++ = '-';
+      std::memcpy(buffer, digits, length);
+      std::memset(buffer + length, '0', point - length);
+      buffer += point;
+      if(precision) {
+        *buffer++ = '.';
+        std::memset(buffer, '0', precision);
+        buffer += precision;
+      }
+      return buffer;
+    }
+
+    static char* exponent(char* buffer, double value, unsigned precision) {
+      double_conversion::StringBuilder builder { buffer, buffer_size(precision) };
+      printf_converter().ToExponential(value, static_cast<int>(precision), &builder);
+      return buffer + builder.position();
+    }
+  };
+}
+
+#endif
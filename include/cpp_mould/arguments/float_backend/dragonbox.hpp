@@ -0,0 +1,19 @@
+#ifndef CPP_MOULD_ARGUMENTS_FLOAT_BACKEND_DRAGONBOX_HPP
+#define CPP_MOULD_ARGUMENTS_FLOAT_BACKEND_DRAGONBOX_HPP
+#include <dragonbox.h>
+
+namespace mould::float_backend {
+  /* Dragonbox as implemented in Drachennest. Only generates the shortest
+   * representation, switching between fixed and exponent notation.
+   */
+  struct Dragonbox {
+    static constexpr bool has_shortest = true;
+    static constexpr bool has_precision = false;
+
+    static char* shortest(char* buffer, double value) {
+      return dragonbox::Dtoa(buffer, value);
+    }
+  };
+}
+
+#endif
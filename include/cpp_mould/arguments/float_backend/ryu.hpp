@@ -0,0 +1,30 @@
+#ifndef CPP_MOULD_ARGUMENTS_FLOAT_BACKEND_RYU_HPP
+#define CPP_MOULD_ARGUMENTS_FLOAT_BACKEND_RYU_HPP
+#include <ryu/ryu.h>
+
+namespace mould::float_backend {
+  /* Ryu by Ulf Adams. The shortest output is always in scientific notation
+   * (`1.5E0`), the precision based output matches printf.
+   */
+  struct Ryu {
+    static constexpr bool has_shortest = true;
+    static constexpr bool has_precision = true;
+    // Any precision is exact, with 1074 fraction digits every double is
+    // written in full and the later digits are zero
+    static constexpr unsigned max_precision = 1074;
+
+    static char* shortest(char* buffer, double value) {
+      return buffer + d2s_buffered_n(value, buffer);
+    }
+
+    static char* fixed(char* buffer, double value, unsigned precision) {
+      return buffer + d2fixed_buffered_n(value, precision, buffer);
+    }
+
+    static char* exponent(char* buffer, double value, unsigned precision) {
+      return buffer + d2exp_buffered_n(value, precision, buffer);
+    }
+  };
+}
+
+#endif
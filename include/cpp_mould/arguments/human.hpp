@@ -0,0 +1,146 @@
+#ifndef CPP_MOULD_ARGUMENTS_HUMAN_HPP
+#define CPP_MOULD_ARGUMENTS_HUMAN_HPP
+/* Integers as sizes and spans of time, with the unit chosen by magnitude. */
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+#include "../argument.hpp"
+#include "../format.hpp"
+#include "digits.hpp"
+
+namespace mould::internal {
+  template<typename T>
+  constexpr bool is_plain_integer = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+  constexpr std::string_view byte_units[] = { "B", "KiB", "MiB", "GiB", "TiB", "PiB", "EiB" };
+  constexpr std::string_view time_units[] = { "ns", "us", "ms", "s" };
+
+  // Sign, up to 1024 with three fraction digits, a space and the unit
+  constexpr size_t bytesize_max_width = 1 + 4 + 1 + 3 + 1 + 3;
+  // Sign, up to 2^64 ns in seconds with nine fraction digits and the unit
+  constexpr size_t timespan_max_width = 1 + 11 + 1 + 9 + 1 + 2;
+
+  // A value in a unit, with `digits` fraction digits
+  struct Scaled {
+    uint64_t whole;
+    uint64_t fraction;
+    unsigned digits;
+    unsigned unit;
+  };
+
+  // The unit is the number of complete 10 bit steps below the highest set
+  // bit. Three fraction digits never need more than the next 10 bits.
+  inline Scaled scale_bytes(uint64_t value, unsigned precision) {
+    const unsigned unit = (63 - std::countl_zero(value | 1))/10;
+    if(!unit)
+      return { value, 0, 0, 0 };
+
+    precision = std::min(precision, 3u);
+    const unsigned shift = 10*unit;
+    const uint64_t part = (value >> (shift - 10)) & 1023;
+    uint64_t whole = value >> shift;
+    uint64_t fraction = (part*powers_of_10[precision] + 512) >> 10;
+
+    if(fraction == powers_of_10[precision]) {
+      whole++;
+      fraction = 0;
+    }
+    if(whole == 1024 && unit + 1 < std::size(byte_units))
+      return { 1, 0, precision, unit + 1 };
+    return { whole, fraction, precision, unit };
+  }
+
+  // Units of a thousand, chosen by the digit count of the nanoseconds.
+  // Anything from a thousand seconds on stays in seconds.
+  inline Scaled scale_nanoseconds(uint64_t value, unsigned precision) {
+    const unsigned unit = std::min((count_digits(value) - 1)/3, 3u);
+    if(!unit)
+      return { value, 0, 0, 0 };
+
+    const unsigned decimals = 3*unit;
+    precision = std::min(precision, decimals);
+    const uint64_t divisor = powers_of_10[decimals];
+    const uint64_t step = powers_of_10[decimals - precision];
+    uint64_t whole = value/divisor;
+    uint64_t fraction = (value % divisor + step/2)/step;
+
+    if(fraction == powers_of_10[precision]) {
+      whole++;
+      fraction = 0;
+    }
+    if(whole == 1000 && unit + 1 < std::size(time_units))
+      return { 1, 0, precision, unit + 1 };
+    return { whole, fraction, precision, unit };
+  }
+
+  inline char* write_scaled(char* out, const Scaled& scaled, std::string_view unit) {
+    out = write_digits(out, scaled.whole);
+    if(scaled.digits) {
+      *out++ = '.';
+      out = write_fixed_digits(out, scaled.fraction, scaled.digits);
+    }
+    *out++ = ' ';
+    std::memcpy(out, unit.data(), unit.size());
+    return out + unit.size();
+  }
+
+  inline unsigned human_precision(const Format& format) {
+    return format.has_precision ? static_cast<unsigned>(format.precision) : 1;
+  }
+}
+
+namespace mould {
+  template<int width>
+  struct HumanResultInformation {
+    constexpr static int max_width = width;
+  };
+
+  /* Standard implementation of sizes in bytes for all integers, with binary
+   * units. The precision is the number of fraction digits, 1 by default and
+   * at most 3.
+   */
+  template<typename T, typename Formatter>
+  auto format_bytesize(const T& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_plain_integer<T>,
+      ResultWithInformation<HumanResultInformation<internal::bytesize_max_width>>> {
+    const auto scaled = internal::scale_bytes(internal::magnitude(value),
+      internal::human_precision(formatter.format()));
+    internal::format_bounded_number<internal::bytesize_max_width>(formatter, value < 0,
+      [&scaled](char* out) {
+        return internal::write_scaled(out, scaled, internal::byte_units[scaled.unit]);
+      });
+    return FormattingResult::Success;
+  }
+
+  /* Standard implementation of spans of time for all integers, counted in
+   * nanoseconds, and for durations with an integral count.
+   */
+  template<typename T, typename Formatter>
+  auto format_timespan(const T& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_plain_integer<T>,
+      ResultWithInformation<HumanResultInformation<internal::timespan_max_width>>> {
+    const auto scaled = internal::scale_nanoseconds(internal::magnitude(value),
+      internal::human_precision(formatter.format()));
+    internal::format_bounded_number<internal::timespan_max_width>(formatter, value < 0,
+      [&scaled](char* out) {
+        return internal::write_scaled(out, scaled, internal::time_units[scaled.unit]);
+      });
+    return FormattingResult::Success;
+  }
+
+  template<typename Rep, typename Period, typename Formatter>
+  auto format_timespan(const std::chrono::duration<Rep, Period>& value, Formatter formatter)
+  -> std::enable_if_t<std::is_integral_v<Rep>,
+      ResultWithInformation<HumanResultInformation<internal::timespan_max_width>>> {
+    const int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(value).count();
+    return format_timespan(nanoseconds, formatter);
+  }
+}
+
+#endif
@@ -1,8 +1,15 @@
 #ifndef CPP_MOULD_ARGUMENTS_INT_HPP
 #define CPP_MOULD_ARGUMENTS_INT_HPP
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 #include "../argument.hpp"
+#include "digits.hpp"
 
 namespace mould {
   /* Standard definition for int */
@@ -11,14 +18,16 @@ namespace mould {
     return AutoFormatting<AutoFormattingChoice::decimal> { };
   }
 
-  template<typename Formatter>
-  FormattingResult format_decimal(const int& pvalue, Formatter formatter) {
-    if(pvalue == 0) {
-      formatter.append('0');
-      return FormattingResult::Success;
-    }
+  struct IntResultInformation {
+    // Sign, digits and group separators
+    constexpr static int max_width = std::numeric_limits<int>::digits10 + 2
+      + std::numeric_limits<int>::digits10/3;
+  };
+}
 
-    int pre_length = (pvalue < 0 || formatter.format().sign != internal::Sign::Default) ? 1 : 0;
+namespace mould::internal {
+  template<typename Formatter>
+  FormattingResult format_int_decimal(const int& pvalue, Formatter& formatter) {
     // This convoluted mess avoids the failure on -MAX_INT
     const unsigned value = (pvalue < 0) ? (~static_cast<unsigned>(pvalue)) + static_cast<unsigned>(1) : pvalue;
 
@@ -30,40 +39,198 @@ namespace mould {
     for(auto cmp : comparisons) {
       number_length += (value >= cmp) ? 1 : 0;
     }
-    const unsigned int formatted_length = number_length;
 
-    int remaining_length = formatter.format().width - number_length;
+    char view[IntResultInformation::max_width] = {};
+    char* result_buffer = formatter.show_buf(formatter.padded_size(sizeof(view)));
+    result_buffer = result_buffer ? result_buffer : view;
+    const auto start = result_buffer;
 
-    if(pvalue < 0) formatter.append('-');
-    else if(formatter.format().sign == internal::Sign::Always) formatter.append('+');
-    else if(formatter.format().sign == internal::Sign::Pad) formatter.append(' ');
+    if(pvalue < 0) *result_buffer++ = '-';
+    else if(formatter.format().sign == Sign::Always) *result_buffer++ = '+';
+    else if(formatter.format().sign == Sign::Pad) *result_buffer++ = ' ';
 
-    const char padding = formatter.format().has_padding ? (char) formatter.format().padding : ' ';
-    for(int i = 0; i < remaining_length; i++) formatter.append(padding);
+    const size_t sign_length = result_buffer - start;
 
-    char view[std::numeric_limits<int>::digits10] = {};
-    char* result_buffer = formatter.show_buf(sizeof(view));
-    result_buffer = result_buffer ? result_buffer : view;
-    const auto start = result_buffer;
+    if(const char separator = formatter.format().grouping) {
+      const auto end = write_grouped_digits(result_buffer, value, number_length, separator);
+      const size_t formatted_length = end - start;
+
+      if (start == view) {
+        formatter.append_padded(std::string_view{view, formatted_length}, Alignment::Right, sign_length);
+      } else {
+        formatter.put_padded(start, formatted_length, Alignment::Right, sign_length);
+      }
+      return FormattingResult::Success;
+    }
+
+    const size_t formatted_length = sign_length + number_length;
 
     for(unsigned iterval = value;;) {
-      if(iterval > 0) result_buffer[number_length - 1] = '0' + (iterval % 10);
-      if(iterval > 10) result_buffer[number_length - 2] = '0' + ((iterval/10) % 10);
-      if(iterval > 100) result_buffer[number_length - 3] = '0' + ((iterval/100) % 10);
-      if(iterval > 1000) result_buffer[number_length - 4] = '0' + ((iterval/1000) % 10);
+      result_buffer[number_length - 1] = '0' + (iterval % 10);
+      if(iterval >= 10) result_buffer[number_length - 2] = '0' + ((iterval/10) % 10);
+      if(iterval >= 100) result_buffer[number_length - 3] = '0' + ((iterval/100) % 10);
+      if(iterval >= 1000) result_buffer[number_length - 4] = '0' + ((iterval/1000) % 10);
       iterval /= 10000;
       number_length -= 4;
       if(number_length <= 0) break;
     }
 
     if (start == view) {
-      formatter.append(std::string_view{view, formatted_length});
+      formatter.append_padded(std::string_view{view, formatted_length}, Alignment::Right, sign_length);
     } else {
-      formatter.put_buf(formatted_length);
+      formatter.put_padded(start, formatted_length, Alignment::Right, sign_length);
     }
 
     return FormattingResult::Success;
   }
+
+  // Python style, negative values are written with their magnitude
+  template<typename Formatter>
+  FormattingResult format_int_hex(const int& value, Formatter& formatter, bool upper) {
+    const uint32_t digits = static_cast<uint32_t>(magnitude(value));
+    format_bounded_number<IntResultInformation::max_width>(formatter, value < 0,
+      [digits, upper](char* out) {
+        return write_hex_digits(out, digits, count_hex_digits(digits), upper);
+      });
+    return FormattingResult::Success;
+  }
+
+  // The width of a `{:0N}` format when nothing else in it changes the
+  // output of a non-negative value, 0 for any other format.
+  constexpr unsigned zero_padded_width(const Formatting& formatting) {
+    if(formatting.width != FormatArgument::Value
+      || formatting.padding != FormatArgument::Value || formatting.padding_value != '0')
+      return 0;
+    if(formatting.precision != FormatArgument::Auto || formatting.sign != Sign::Default
+      || formatting.grouping != Grouping::None)
+      return 0;
+    if(formatting.alignment != Alignment::Default && formatting.alignment != Alignment::Right)
+      return 0;
+    return formatting.width_value;
+  }
+
+  constexpr unsigned max_zero_padded_width = 16;
+
+  /* Kernel for `{:0Nd}` and `{:0Nx}` chosen at compile time: the digits are
+   * written exactly, no field of the format is read. Negative values take
+   * the generic path, as the sign goes before the zeros.
+   */
+  template<unsigned Width, unsigned Base, bool Upper>
+  FormattingResult format_int_zero_padded(const int& value, Formatter formatter) {
+    if(value < 0) {
+      if constexpr(Base == 10) return format_int_decimal(value, formatter);
+      else return format_int_hex(value, formatter, Upper);
+    }
+
+    const auto digits = static_cast<unsigned>(value);
+    const unsigned count = std::max(Width, Base == 10 ? count_digits(digits) : count_hex_digits(digits));
+    constexpr size_t capacity = std::max<size_t>(Width, IntResultInformation::max_width);
+
+    char buffer[capacity];
+    char* const reserved = formatter.show_buf(capacity);
+    char* const start = reserved ? reserved : buffer;
+
+    if constexpr(Base == 10) write_fixed_digits(start, digits, count);
+    else write_hex_digits(start, digits, count, Upper);
+
+    if(reserved)
+      formatter.put_buf(count);
+    else
+      formatter.append(std::string_view{buffer, count});
+    return FormattingResult::Success;
+  }
+
+  template<unsigned Base, bool Upper, size_t ... Widths>
+  constexpr auto int_zero_padded_kernels(std::index_sequence<Widths...>) {
+    return std::array<FormattingResult (*)(const int&, Formatter), sizeof...(Widths)> {
+      format_int_zero_padded<Widths, Base, Upper> ...
+    };
+  }
+
+  template<unsigned Base, bool Upper>
+  struct IntZeroPaddedChooser {
+    constexpr static int max_width = IntResultInformation::max_width;
+    constexpr static auto kernels = int_zero_padded_kernels<Base, Upper>(
+      std::make_index_sequence<max_zero_padded_width + 1>{});
+
+    static constexpr FormattingResult (*get(FullOperation operation))(const int&, Formatter) {
+      const unsigned width = zero_padded_width(operation.formatting);
+      return (width && width <= max_zero_padded_width) ? kernels[width] : nullptr;
+    }
+  };
+}
+
+namespace mould {
+  template<typename Formatter>
+  FineGrainedFormatChoice<internal::IntZeroPaddedChooser<10, false>>
+  format_decimal(const int& value, Formatter formatter) {
+    return internal::format_int_decimal(value, formatter);
+  }
+
+  template<typename Formatter>
+  FineGrainedFormatChoice<internal::IntZeroPaddedChooser<16, false>>
+  format_hex(const int& value, Formatter formatter) {
+    return internal::format_int_hex(value, formatter, false);
+  }
+
+  template<typename Formatter>
+  FineGrainedFormatChoice<internal::IntZeroPaddedChooser<16, true>>
+  format_HEX(const int& value, Formatter formatter) {
+    return internal::format_int_hex(value, formatter, true);
+  }
+}
+
+namespace mould::internal {
+  // 64 bit integers keep all their digits, narrower types are formatted as int
+  template<typename T>
+  constexpr bool is_wide_integer = std::is_integral_v<T> && sizeof(T) == sizeof(uint64_t);
+}
+
+namespace mould {
+  struct WideIntResultInformation {
+    // Sign, digits and group separators
+    constexpr static int max_width = std::numeric_limits<uint64_t>::digits10 + 2
+      + std::numeric_limits<uint64_t>::digits10/3;
+  };
+
+  template<typename T, typename Choice>
+  constexpr auto format_auto(const T&, const Choice& choice)
+  -> std::enable_if_t<internal::is_wide_integer<T>, AutoFormatting<AutoFormattingChoice::decimal>> {
+    return AutoFormatting<AutoFormattingChoice::decimal> { };
+  }
+
+  template<typename T, typename Formatter>
+  auto format_decimal(const T& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_wide_integer<T>, ResultWithInformation<WideIntResultInformation>> {
+    const uint64_t digits = internal::magnitude(value);
+    const char separator = formatter.format().grouping;
+    internal::format_bounded_number<WideIntResultInformation::max_width>(formatter, value < 0,
+      [digits, separator](char* out) {
+        const unsigned count = internal::count_digits(digits);
+        return separator
+          ? internal::write_grouped_digits(out, digits, count, separator)
+          : internal::write_fixed_digits(out, digits, count);
+      });
+    return FormattingResult::Success;
+  }
+
+  template<typename T, typename Formatter>
+  auto format_hex(const T& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_wide_integer<T>, ResultWithInformation<WideIntResultInformation>> {
+    const uint64_t digits = internal::magnitude(value);
+    internal::format_bounded_number<WideIntResultInformation::max_width>(formatter, value < 0,
+      [digits](char* out) { return internal::write_hex_digits(out, digits, internal::count_hex_digits(digits), false); });
+    return FormattingResult::Success;
+  }
+
+  template<typename T, typename Formatter>
+  auto format_HEX(const T& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_wide_integer<T>, ResultWithInformation<WideIntResultInformation>> {
+    const uint64_t digits = internal::magnitude(value);
+    internal::format_bounded_number<WideIntResultInformation::max_width>(formatter, value < 0,
+      [digits](char* out) { return internal::write_hex_digits(out, digits, internal::count_hex_digits(digits), true); });
+    return FormattingResult::Success;
+  }
 }
 
 #endif
@@ -0,0 +1,249 @@
+#ifndef CPP_MOULD_ARGUMENTS_NET_HPP
+#define CPP_MOULD_ARGUMENTS_NET_HPP
+/* IPv4 and IPv6 addresses and UUIDs, without inet_ntop. */
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "../argument.hpp"
+#include "bytes.hpp"
+#include "enum.hpp"
+
+#if __has_include(<netinet/in.h>)
+#include <netinet/in.h>
+#define CPP_MOULD_HAS_NETINET 1
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace mould {
+  // Addresses in network byte order, as in in_addr and in6_addr
+  struct Ipv4Address {
+    std::array<uint8_t, 4> bytes;
+  };
+
+  struct Ipv6Address {
+    std::array<uint8_t, 16> bytes;
+  };
+
+  struct Uuid {
+    std::array<uint8_t, 16> bytes;
+  };
+}
+
+namespace mould::internal {
+  constexpr size_t ipv4_max_width = 15;
+  constexpr size_t ipv6_max_width = 39;
+  constexpr size_t uuid_max_width = 36;
+
+  struct Octet {
+    char text[3];
+    unsigned char length;
+  };
+
+  constexpr auto make_octet_table() {
+    std::array<Octet, 256> table = {};
+    for(unsigned value = 0; value < 256; value++) {
+      auto& octet = table[value];
+      if(value >= 100) octet.text[octet.length++] = static_cast<char>('0' + value/100);
+      if(value >= 10) octet.text[octet.length++] = static_cast<char>('0' + value/10 % 10);
+      octet.text[octet.length++] = static_cast<char>('0' + value % 10);
+    }
+    return table;
+  }
+
+  constexpr auto octet_table = make_octet_table();
+
+  inline char* write_ipv4(char* out, const unsigned char* in) {
+    for(unsigned i = 0; i < 4; i++) {
+      const Octet& octet = octet_table[in[i]];
+      if(i) *out++ = '.';
+      std::memcpy(out, octet.text, 3);
+      out += octet.length;
+    }
+    return out;
+  }
+
+  // Bit `i` is set if the 16 bit group `i` is zero
+  inline unsigned zero_groups(const unsigned char* in) {
+#if defined(__SSE2__)
+    const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    const __m128i zero = _mm_setzero_si128();
+    // Narrowed to one byte per group, such that each group is one bit
+    const __m128i equal = _mm_packs_epi16(_mm_cmpeq_epi16(words, zero), zero);
+    return static_cast<unsigned>(_mm_movemask_epi8(equal));
+#else
+    unsigned mask = 0;
+    for(unsigned i = 0; i < 8; i++)
+      mask |= (in[2*i] | in[2*i + 1]) ? 0u : 1u << i;
+    return mask;
+#endif
+  }
+
+  // RFC 5952: lowercase groups without leading zeros, the first longest run
+  // of at least two zero groups as "::" and IPv4 mapped addresses with the
+  // IPv4 notation.
+  inline char* write_ipv6(char* out, const unsigned char* in) {
+    const unsigned zeros = zero_groups(in);
+
+    if((zeros & 0x1F) == 0x1F && in[10] == 0xFF && in[11] == 0xFF) {
+      std::memcpy(out, "::ffff:", 7);
+      return write_ipv4(out + 7, in + 12);
+    }
+
+    unsigned run_start = 0, run_length = 0;
+    for(unsigned rest = zeros, at = 0; rest; ) {
+      const unsigned skip = std::countr_zero(rest);
+      at += skip;
+      rest >>= skip;
+      const unsigned length = std::countr_one(rest);
+      if(length > run_length) {
+        run_start = at;
+        run_length = length;
+      }
+      at += length;
+      rest >>= length;
+    }
+    if(run_length < 2)
+      run_length = 0;
+
+    constexpr char digits[] = "0123456789abcdef";
+    for(unsigned group = 0; group < 8; group++) {
+      if(run_length && group == run_start) {
+        *out++ = ':';
+        *out++ = ':';
+        group += run_length - 1;
+        continue;
+      }
+      if(group && !(run_length && group == run_start + run_length))
+        *out++ = ':';
+
+      const uint16_t value = static_cast<uint16_t>(in[2*group] << 8 | in[2*group + 1]);
+      const int count = value ? (19 - std::countl_zero(value))/4 : 1;
+      for(int i = count - 1; i >= 0; i--)
+        *out++ = digits[(value >> 4*i) & 0xF];
+    }
+    return out;
+  }
+
+  // The 32 digits with one vector pass, then moved apart for the dashes
+  inline char* write_uuid(char* out, const unsigned char* in, bool upper) {
+    char hex[32];
+    encode_hex(in, 16, hex, upper);
+    constexpr unsigned parts[] = { 8, 4, 4, 4, 12 };
+    const char* from = hex;
+    for(unsigned i = 0; i < 5; i++) {
+      if(i) *out++ = '-';
+      std::memcpy(out, from, parts[i]);
+      out += parts[i];
+      from += parts[i];
+    }
+    return out;
+  }
+
+  template<size_t width>
+  struct AddressResultInformation {
+    constexpr static int max_width = width;
+  };
+
+  template<typename Formatter>
+  FormattingResult format_ipv4(const unsigned char* bytes, Formatter& formatter) {
+    format_bounded_text<ipv4_max_width>(formatter, [bytes](char* out) -> size_t {
+      return write_ipv4(out, bytes) - out;
+    });
+    return FormattingResult::Success;
+  }
+
+  template<typename Formatter>
+  FormattingResult format_ipv6(const unsigned char* bytes, Formatter& formatter) {
+    format_bounded_text<ipv6_max_width>(formatter, [bytes](char* out) -> size_t {
+      return write_ipv6(out, bytes) - out;
+    });
+    return FormattingResult::Success;
+  }
+
+  template<typename Formatter>
+  FormattingResult format_uuid(const unsigned char* bytes, Formatter& formatter, bool upper) {
+    format_bounded_text<uuid_max_width>(formatter, [bytes, upper](char* out) -> size_t {
+      return write_uuid(out, bytes, upper) - out;
+    });
+    return FormattingResult::Success;
+  }
+
+  template<typename T>
+  constexpr bool is_ipv4 = std::is_same_v<T, Ipv4Address>
+#ifdef CPP_MOULD_HAS_NETINET
+    || std::is_same_v<T, in_addr>
+#endif
+    ;
+
+  template<typename T>
+  constexpr bool is_ipv6 = std::is_same_v<T, Ipv6Address>
+#ifdef CPP_MOULD_HAS_NETINET
+    || std::is_same_v<T, in6_addr>
+#endif
+    ;
+
+  template<typename T>
+  const unsigned char* address_bytes(const T& value) {
+    if constexpr(std::is_same_v<T, Ipv4Address> || std::is_same_v<T, Ipv6Address>)
+      return value.bytes.data();
+    else
+      return reinterpret_cast<const unsigned char*>(&value);
+  }
+}
+
+namespace mould {
+  /* Standard implementation for Ipv4Address and in_addr */
+  template<typename T, typename Choice>
+  constexpr auto format_auto(const T&, Choice choice)
+  -> std::enable_if_t<internal::is_ipv4<T> || internal::is_ipv6<T>,
+      AutoFormatting<AutoFormattingChoice::string>> {
+    return AutoFormatting<AutoFormattingChoice::string> { };
+  }
+
+  template<typename T, typename Formatter>
+  auto format_string(const T& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_ipv4<T>,
+      ResultWithInformation<internal::AddressResultInformation<internal::ipv4_max_width>>> {
+    return internal::format_ipv4(internal::address_bytes(value), formatter);
+  }
+
+  /* Standard implementation for Ipv6Address and in6_addr */
+  template<typename T, typename Formatter>
+  auto format_string(const T& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_ipv6<T>,
+      ResultWithInformation<internal::AddressResultInformation<internal::ipv6_max_width>>> {
+    return internal::format_ipv6(internal::address_bytes(value), formatter);
+  }
+
+  /* Standard implementation for Uuid, lowercase unless `{:X}` */
+  template<typename Choice>
+  constexpr AutoFormatting<AutoFormattingChoice::hex> format_auto(const Uuid&, Choice choice) {
+    return AutoFormatting<AutoFormattingChoice::hex> { };
+  }
+
+  template<typename Formatter>
+  ResultWithInformation<internal::AddressResultInformation<internal::uuid_max_width>>
+  format_hex(const Uuid& value, Formatter formatter) {
+    return internal::format_uuid(value.bytes.data(), formatter, false);
+  }
+
+  template<typename Formatter>
+  ResultWithInformation<internal::AddressResultInformation<internal::uuid_max_width>>
+  format_HEX(const Uuid& value, Formatter formatter) {
+    return internal::format_uuid(value.bytes.data(), formatter, true);
+  }
+
+  template<typename Formatter>
+  ResultWithInformation<internal::AddressResultInformation<internal::uuid_max_width>>
+  format_string(const Uuid& value, Formatter formatter) {
+    return internal::format_uuid(value.bytes.data(), formatter, false);
+  }
+}
+
+#endif
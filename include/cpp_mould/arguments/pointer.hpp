@@ -1,5 +1,7 @@
 #ifndef CPP_MOULD_ARGUMENTS_POINTER_HPP
 #define CPP_MOULD_ARGUMENTS_POINTER_HPP
+#include <algorithm>
+
 #include "../argument.hpp"
 
 #ifdef __has_include
@@ -23,15 +25,15 @@ namespace mould {
 
     size_t asint = (size_t) ptr;
     const size_t lzeroch = std::countl_zero(asint) / 4;
-    const size_t width = 2*sizeof(void*) - lzeroch;
+    const size_t width = asint ? 2*sizeof(void*) - lzeroch : 1;
 
-    char* result_buffer = formatter.show_buf(2 + width);
+    char* result_buffer = formatter.show_buf(formatter.padded_size(2 + width));
     result_buffer = result_buffer ? result_buffer : buffer;
     const auto start = result_buffer;
 
-    for(int i = width; i >= 0; i--) {
+    for(size_t i = width; i > 0; i--) {
         auto chr = asint & 0xF;
-        result_buffer[2+i] = chr < 10 ? '0' + chr : 'a' + chr - 10;
+        result_buffer[1+i] = chr < 10 ? '0' + chr : 'a' + chr - 10;
         asint >>= 4;
     }
 
@@ -39,9 +41,9 @@ namespace mould {
     result_buffer[1] = 'x';
 
     if (start == buffer) {
-      formatter.append(std::string_view{buffer, 2 + width});
+      formatter.append_padded(std::string_view{buffer, 2 + width}, internal::Alignment::Right, 2);
     } else {
-      formatter.put_buf(2 + width);
+      formatter.put_padded(start, 2 + width, internal::Alignment::Right, 2);
     }
 
     return FormattingResult::Success;
@@ -62,7 +64,7 @@ namespace mould {
 
     size_t asint = (size_t) ptr;
     
-    int begin_index = 2*sizeof(void*) + 2;
+    int begin_index = 2*sizeof(void*);
     for(int i = 2*sizeof(void*) - 1; i >= 0; i--) {
         auto chr = asint & 0xF;
         if(chr != 0) begin_index = i;
@@ -70,10 +72,14 @@ namespace mould {
         asint >>= 4;
     }
 
+    // Always keep at least one digit, for the null pointer
+    begin_index = std::min(begin_index, (int) (2*sizeof(void*) - 1));
     buffer[begin_index] = '0';
     buffer[begin_index + 1] = 'x';
 
-    formatter.append(std::string_view{buffer + begin_index, 2*sizeof(void*) + 3 - begin_index});
+    formatter.append_padded(
+      std::string_view{buffer + begin_index, 2*sizeof(void*) + 2 - begin_index},
+      internal::Alignment::Right, 2);
     
     return FormattingResult::Success;
   }
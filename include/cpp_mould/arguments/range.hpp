@@ -0,0 +1,150 @@
+#ifndef CPP_MOULD_ARGUMENTS_RANGE_HPP
+#define CPP_MOULD_ARGUMENTS_RANGE_HPP
+/* Contiguous ranges of any formattable element type. */
+#include <algorithm>
+#include <array>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "../argument.hpp"
+#include "../engine.hpp"
+#include "../format_info.hpp"
+#include "bytes.hpp"
+
+namespace mould::internal {
+  template<typename R>
+  struct RangeTraits { };
+
+  // vector<bool> is not contiguous and not a range of bool
+  template<typename T, typename A>
+  struct RangeTraits<std::vector<T, A>>
+  : std::enable_if<!std::is_same_v<T, bool>, T> { };
+
+  template<typename T, size_t N>
+  struct RangeTraits<std::array<T, N>> {
+    using type = T;
+  };
+
+  // Spans of bytes are formatted as data, see "bytes.hpp"
+  template<typename T, size_t E>
+  struct RangeTraits<std::span<T, E>>
+  : std::enable_if<!is_byte<T>, std::remove_const_t<T>> { };
+
+  template<typename R>
+  using range_element = typename RangeTraits<R>::type;
+
+  // The spec extension gives the delimiters: `|sep` for only a separator,
+  // `|open|sep|close` for all of them. Without one, `[a, b, c]` is written.
+  // Braces are doubled as in `{:|{{|, |}}}`, a delimiter can not hold '|'.
+  struct RangeDelimiters {
+    std::string_view open;
+    std::string_view separator;
+    std::string_view close;
+    bool escaped; // If any delimiter holds a doubled brace
+
+    static RangeDelimiters parse(std::string_view extension) {
+      if(extension.empty())
+        return { "[", ", ", "]", false };
+
+      const bool escaped = extension.find_first_of("{}") != extension.npos;
+      const auto first = extension.find('|');
+      const auto second = first == extension.npos ? first : extension.find('|', first + 1);
+      if(second == extension.npos)
+        return { {}, extension, {}, escaped };
+
+      return {
+        extension.substr(0, first),
+        extension.substr(first + 1, second - first - 1),
+        extension.substr(second + 1),
+        escaped,
+      };
+    }
+
+    void append(Formatter& out, std::string_view delimiter) const {
+      if(!escaped) {
+        out.append(delimiter);
+        return;
+      }
+      // Each brace is followed by its double, which is skipped
+      for(auto brace = delimiter.find_first_of("{}"); brace != delimiter.npos;
+          brace = delimiter.find_first_of("{}")) {
+        out.append(delimiter.substr(0, brace + 1));
+        delimiter.remove_prefix(std::min(brace + 2, delimiter.size()));
+      }
+      out.append(delimiter);
+    }
+  };
+
+  template<auto element, typename R>
+  FormattingResult write_range(const R& range, Formatter out, const RangeDelimiters& delimiters) {
+    delimiters.append(out, delimiters.open);
+    bool first = true;
+    for(const auto& item : range) {
+      if(!first) delimiters.append(out, delimiters.separator);
+      first = false;
+      if(element(item, out) == FormattingResult::Error)
+        return FormattingResult::Error;
+    }
+    delimiters.append(out, delimiters.close);
+    return FormattingResult::Success;
+  }
+
+  // The elements get the format without the extension. If their width is
+  // bounded, the whole range is reserved with one show_buf and written
+  // without further checks of the output.
+  template<auto element, int max_width, typename R>
+  FormattingResult format_range(const R& range, Formatter& formatter) {
+    const auto delimiters = RangeDelimiters::parse(formatter.format().extension);
+    auto format = formatter.format();
+    format.extension = {};
+
+    if constexpr(max_width >= 0) {
+      const size_t count = std::size(range);
+      const size_t element_width = std::max<size_t>(max_width, format.width);
+      const size_t reserve = delimiters.open.size() + delimiters.close.size()
+        + count*element_width + (count ? count - 1 : 0)*delimiters.separator.size();
+
+      if(char* buffer = formatter.show_buf(reserve)) {
+        SpanEngine engine{buffer, buffer + reserve};
+        const auto result = write_range<element>(range, Formatter{engine, format}, delimiters);
+        formatter.put_buf(engine.written());
+        return result;
+      }
+    }
+
+    return write_range<element>(range, formatter.with_format(format), delimiters);
+  }
+}
+
+namespace mould {
+  /* Standard implementation for std::vector, std::array and std::span. The
+   * elements are formatted with the kind and format of the range, the
+   * element formatter is resolved once at compile time.
+   */
+  template<typename R, typename Choice>
+  constexpr auto format_auto(const R&, Choice choice)
+  -> AutoFormatting<decltype(format_auto(
+      std::declval<const internal::range_element<R>&>(), choice))::value> {
+    return { };
+  }
+
+#define CPP_MOULD_RANGE_FORMAT(kind) \
+  template<typename R, typename Formatter> \
+  auto format_##kind(const R& range, Formatter formatter) \
+  -> std::enable_if_t< \
+      internal::TypedFormatter<internal::range_element<R>>:: kind \
+        .get(internal::FullOperation{}) != nullptr, \
+      FormattingResult> \
+  { \
+    constexpr auto& element = internal::TypedFormatter<internal::range_element<R>>:: kind; \
+    return internal::format_range<element.get(internal::FullOperation{}), element.max_width>( \
+      range, formatter); \
+  }
+
+  CPP_MOULD_REPEAT_FOR_FORMAT_KINDS_MACRO(CPP_MOULD_RANGE_FORMAT)
+#undef CPP_MOULD_RANGE_FORMAT
+}
+
+#endif
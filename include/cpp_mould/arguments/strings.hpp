@@ -1,21 +1,77 @@
 #ifndef CPP_MOULD_ARGUMENTS_STRINGS_HPP
 #define CPP_MOULD_ARGUMENTS_STRINGS_HPP
+#include <cstring>
+#include <string>
+#include <type_traits>
+
 #include "../format.hpp"
+#include "../simd.hpp"
+#include "escape.hpp"
+
+namespace mould::internal {
+  template<typename T>
+  constexpr bool is_c_string = std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+
+  // Writes a string of known length, truncated to the precision and padded
+  // to the width of the format. The characters are copied exactly once.
+  template<typename Formatter>
+  FormattingResult format_text(std::string_view value, Formatter& formatter) {
+    const auto& format = formatter.format();
+    if(format.has_precision && format.precision < value.size())
+      value = value.substr(0, format.precision);
+    formatter.append_padded(value, Alignment::Left);
+    return FormattingResult::Success;
+  }
+
+  // The length of a nul terminated string, but scanning at most `max` chars.
+  inline size_t bounded_str_len(const char* value, size_t max) {
+    const void* nul = std::memchr(value, 0, max);
+    return nul ? static_cast<const char*>(nul) - value : max;
+  }
+}
 
 namespace mould {
-  /* Standard implementation for const char* */
-  template<typename Choice>
-  constexpr AutoFormatting<AutoFormattingChoice::string> format_auto(const char*, Choice choice) {
+  /* Standard implementation for const char*. These only accept actual
+   * pointers, char arrays are no longer decayed and find their own overload.
+   */
+  template<typename T, typename Choice>
+  constexpr auto format_auto(const T&, Choice choice)
+  -> std::enable_if_t<internal::is_c_string<T>, AutoFormatting<AutoFormattingChoice::string>> {
     return AutoFormatting<AutoFormattingChoice::string> { };
   }
 
-  template<typename Formatter>
-  FormattingResult format_string(const char* value, Formatter formatter) {
-    formatter.append(value);
+  template<typename T, typename Formatter>
+  auto format_string(const T& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_c_string<T>, FormattingResult> {
+    const auto& format = formatter.format();
+    if(format.has_precision) {
+      const auto length = internal::bounded_str_len(value, format.precision);
+      formatter.append_padded(std::string_view{value, length}, internal::Alignment::Left);
+    } else if(format.has_width) {
+      const auto length = internal::str_len(value);
+      formatter.append_padded(std::string_view{value, length}, internal::Alignment::Left);
+    } else {
+      formatter.append(value);
+    }
     return FormattingResult::Success;
   }
 
-  /* Standard implementation for const char&[N] */
+  template<typename T, typename Formatter>
+  auto format_json(const T& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_c_string<T>, FormattingResult> {
+    const auto length = internal::str_len(value);
+    return internal::format_escaped<internal::EscapeStyle::Json>({value, length}, formatter);
+  }
+
+  template<typename T, typename Formatter>
+  auto format_quoted(const T& value, Formatter formatter)
+  -> std::enable_if_t<internal::is_c_string<T>, FormattingResult> {
+    const auto length = internal::str_len(value);
+    return internal::format_escaped<internal::EscapeStyle::C>({value, length}, formatter);
+  }
+
+  /* Standard implementation for const char&[N], the string ends at the first
+   * nul character or the end of the array. */
   template<size_t N, typename Choice>
   constexpr AutoFormatting<AutoFormattingChoice::string> format_auto(const char(&val)[N], Choice choice) {
     return AutoFormatting<AutoFormattingChoice::string> { };
@@ -23,8 +79,20 @@ namespace mould {
 
   template<size_t N, typename Formatter>
   FormattingResult format_string(const char(&value)[N], Formatter formatter) {
-    formatter.append(std::string_view{value, N});
-    return FormattingResult::Success;
+    const auto length = internal::bounded_str_len(value, N);
+    return internal::format_text(std::string_view{value, length}, formatter);
+  }
+
+  template<size_t N, typename Formatter>
+  FormattingResult format_json(const char(&value)[N], Formatter formatter) {
+    const auto length = internal::bounded_str_len(value, N);
+    return internal::format_escaped<internal::EscapeStyle::Json>({value, length}, formatter);
+  }
+
+  template<size_t N, typename Formatter>
+  FormattingResult format_quoted(const char(&value)[N], Formatter formatter) {
+    const auto length = internal::bounded_str_len(value, N);
+    return internal::format_escaped<internal::EscapeStyle::C>({value, length}, formatter);
   }
 
   /* Standard implementation for std::string_view */
@@ -35,8 +103,38 @@ namespace mould {
 
   template<typename Formatter>
   FormattingResult format_string(const std::string_view value, Formatter formatter) {
-    formatter.append(value);
-    return FormattingResult::Success;
+    return internal::format_text(value, formatter);
+  }
+
+  template<typename Formatter>
+  FormattingResult format_json(const std::string_view value, Formatter formatter) {
+    return internal::format_escaped<internal::EscapeStyle::Json>(value, formatter);
+  }
+
+  template<typename Formatter>
+  FormattingResult format_quoted(const std::string_view value, Formatter formatter) {
+    return internal::format_escaped<internal::EscapeStyle::C>(value, formatter);
+  }
+
+  /* Standard implementation for std::string */
+  template<typename Choice>
+  constexpr AutoFormatting<AutoFormattingChoice::string> format_auto(const std::string&, Choice choice) {
+    return AutoFormatting<AutoFormattingChoice::string> { };
+  }
+
+  template<typename Formatter>
+  FormattingResult format_string(const std::string& value, Formatter formatter) {
+    return internal::format_text(std::string_view{value}, formatter);
+  }
+
+  template<typename Formatter>
+  FormattingResult format_json(const std::string& value, Formatter formatter) {
+    return internal::format_escaped<internal::EscapeStyle::Json>(value, formatter);
+  }
+
+  template<typename Formatter>
+  FormattingResult format_quoted(const std::string& value, Formatter formatter) {
+    return internal::format_escaped<internal::EscapeStyle::C>(value, formatter);
   }
 
   /* Standard implementation for char */
@@ -47,13 +145,13 @@ namespace mould {
 
   template<typename Formatter>
   FormattingResult format_string(const char value, Formatter formatter) {
-    formatter.append(value);
+    formatter.append_padded(std::string_view{&value, 1}, internal::Alignment::Left);
     return FormattingResult::Success;
   }
 
   template<typename Formatter>
   FormattingResult format_character(const char value, Formatter formatter) {
-    formatter.append(value);
+    formatter.append_padded(std::string_view{&value, 1}, internal::Alignment::Left);
     return FormattingResult::Success;
   }
 }
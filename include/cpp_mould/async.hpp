@@ -0,0 +1,374 @@
+#ifndef CPP_MOULD_ASYNC_HPP
+#define CPP_MOULD_ASYNC_HPP
+/* Formatting on a pool of worker threads.
+ *
+ * A call copies its arguments into a slot of the bounded queue of its sink
+ * and returns. Workers own one sink at a time, format its queued calls in
+ * order with the constexpr driver and hand the output to the sink in one
+ * piece. A worker without work in its own sink takes over any other sink
+ * with queued calls.
+ */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "engine.hpp"
+#include "constexpr_driver.hpp"
+#include "arguments/strings.hpp"
+
+namespace mould {
+  // What a call does when the queue of its sink is full
+  enum struct Backpressure {
+    Block /* wait for a worker to free a slot */,
+    Drop /* discard the call */,
+    Count /* discard the call and count it in `AsyncSink::dropped` */,
+  };
+}
+
+namespace mould::internal {
+  constexpr size_t async_slot_size = 256;
+
+  // Views and character pointers may not outlive the call, their text is
+  // copied instead
+  template<typename T>
+  struct AsyncCapture {
+    using type = std::conditional_t<
+      is_c_string<T> || std::is_same_v<T, std::string_view>, std::string, T>;
+  };
+
+  // The elements of a span, formatted as span of the copy
+  template<typename T>
+  struct AsyncSpan {
+    static_assert(!std::is_pointer_v<T> && !is_view<T>,
+      "Spans of pointers or views can not be queued");
+
+    template<typename Element, size_t E>
+    explicit AsyncSpan(std::span<Element, E> value)
+      : elements(value.begin(), value.end()) { }
+
+    std::vector<T> elements;
+  };
+
+  template<typename T, size_t E>
+  struct AsyncCapture<std::span<T, E>> {
+    using type = AsyncSpan<std::remove_const_t<T>>;
+  };
+
+  // Named arguments refer to their value, which is copied with the name
+  template<FixedName Name, typename T>
+  struct AsyncCapture<NamedArgument<Name, T>> {
+    using type = NamedArgument<Name, typename AsyncCapture<std::decay_t<T>>::type>;
+  };
+
+  template<typename T>
+  using async_capture = typename AsyncCapture<std::decay_t<T>>::type;
+
+  template<typename T>
+  async_capture<T> async_copy(T&& argument) {
+    static_assert(!is_view<async_capture<T>>, "A view can not be queued");
+    if constexpr(is_named_argument<std::decay_t<T>>)
+      return { async_capture<decltype(argument.value)>(argument.value) };
+    else
+      return async_capture<T>(std::forward<T>(argument));
+  }
+
+  // The value given to the formatter for a captured argument
+  template<typename T>
+  const T& async_formatted(const T& value) {
+    return value;
+  }
+
+  template<typename T>
+  std::span<const T> async_formatted(const AsyncSpan<T>& value) {
+    return value.elements;
+  }
+
+  template<FixedName Name, typename T>
+  NamedArgument<Name, std::span<const T>> async_formatted(const NamedArgument<Name, AsyncSpan<T>>& value) {
+    return { value.value.elements };
+  }
+
+  struct alignas(64) AsyncCell {
+    std::atomic<size_t> sequence;
+    // Formats the captured arguments and destroys them
+    void (*run)(void* arguments, std::string& output);
+    alignas(16) unsigned char arguments[async_slot_size - 16];
+  };
+
+  template<typename Format, typename ... Arguments>
+  struct AsyncCall {
+    using Captured = std::tuple<async_capture<Arguments>...>;
+
+    static_assert(sizeof(Captured) <= sizeof(AsyncCell::arguments),
+      "The arguments do not fit into an asynchronous slot");
+    static_assert(alignof(Captured) <= 16);
+
+    static void run(void* arguments, std::string& output) {
+      Captured& values = *std::launder(reinterpret_cast<Captured*>(arguments));
+      std::apply([&output](const auto& ... values) {
+        StringEngine engine{output};
+        constexpr_driver::eval<Format>(engine, async_formatted(values)...);
+      }, values);
+      values.~Captured();
+    }
+  };
+}
+
+namespace mould {
+  class AsyncPool;
+
+  /* An output with its queue of pending calls. Created by and owned by an
+   * AsyncPool, the output is only called by one worker at a time.
+   */
+  class AsyncSink {
+  public:
+    AsyncSink(std::function<void(std::string_view)> output, Backpressure backpressure, size_t capacity)
+      : output(std::move(output)), backpressure(backpressure),
+        mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+        cells(new internal::AsyncCell[mask + 1])
+    {
+      for(size_t i = 0; i <= mask; i++)
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Calls discarded with Backpressure::Count
+    inline uint64_t dropped() const {
+      return dropped_calls.load(std::memory_order_relaxed);
+    }
+
+    inline bool idle() const {
+      return enqueue_at.load(std::memory_order_acquire) == dequeue_at.load(std::memory_order_acquire)
+        && !busy.load(std::memory_order_acquire);
+    }
+
+  private:
+    friend class AsyncPool;
+
+    template<typename Format, typename ... Arguments>
+    friend bool async_write(Format&, AsyncSink&, Arguments&&...);
+
+    // A free cell by the bounded queue of D. Vyukov, nullptr when full
+    inline internal::AsyncCell* claim(size_t& at) {
+      at = enqueue_at.load(std::memory_order_relaxed);
+      for(;;) {
+        internal::AsyncCell& cell = cells[at & mask];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(at);
+        if(difference == 0) {
+          if(enqueue_at.compare_exchange_weak(at, at + 1, std::memory_order_relaxed))
+            return &cell;
+        } else if(difference < 0) {
+          return nullptr;
+        } else {
+          at = enqueue_at.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    inline bool try_own() {
+      return enqueue_at.load(std::memory_order_relaxed) != dequeue_at.load(std::memory_order_relaxed)
+        && !busy.exchange(true, std::memory_order_acquire);
+    }
+
+    // Only while owned, formats up to `limit` calls and writes them at once
+    inline size_t run(std::string& buffer, size_t limit) {
+      buffer.clear();
+      size_t at = dequeue_at.load(std::memory_order_relaxed), count = 0;
+      for(; count < limit; count++, at++) {
+        internal::AsyncCell& cell = cells[at & mask];
+        if(cell.sequence.load(std::memory_order_acquire) != at + 1)
+          break;
+        cell.run(cell.arguments, buffer);
+        cell.sequence.store(at + mask + 1, std::memory_order_release);
+        dequeue_at.store(at + 1, std::memory_order_release);
+      }
+      if(!buffer.empty())
+        output(buffer);
+      busy.store(false, std::memory_order_release);
+      return count;
+    }
+
+    std::function<void(std::string_view)> output;
+    const Backpressure backpressure;
+    const size_t mask;
+    std::unique_ptr<internal::AsyncCell[]> cells;
+    AsyncPool* pool = nullptr;
+
+    alignas(64) std::atomic<size_t> enqueue_at{0};
+    std::atomic<uint64_t> dropped_calls{0};
+    alignas(64) std::atomic<size_t> dequeue_at{0};
+    std::atomic<bool> busy{false};
+  };
+
+  /* Worker threads shared by a fixed set of sinks. The destructor formats
+   * all queued calls before it joins the workers.
+   */
+  class AsyncPool {
+  public:
+    constexpr static size_t max_sinks = 64;
+    // Calls formatted before the output of a sink is written
+    constexpr static size_t batch = 64;
+
+    explicit AsyncPool(size_t workers = std::max(1u, std::thread::hardware_concurrency()/2)) {
+      for(size_t i = 0; i < workers; i++)
+        threads.emplace_back([this, i] { work(i); });
+    }
+
+    ~AsyncPool() {
+      stopping.store(true, std::memory_order_seq_cst);
+      wake();
+      for(auto& thread : threads)
+        thread.join();
+    }
+
+    /* A sink writing to `output`. The pool keeps it until it is destroyed.
+     * Returns nullptr if there are already max_sinks sinks.
+     */
+    AsyncSink* add_sink(
+      std::function<void(std::string_view)> output,
+      Backpressure backpressure = Backpressure::Block,
+      size_t capacity = 4096)
+    {
+      std::lock_guard lock{adding};
+      const size_t index = sink_count.load(std::memory_order_relaxed);
+      if(index == max_sinks)
+        return nullptr;
+      owned.push_back(std::make_unique<AsyncSink>(std::move(output), backpressure, capacity));
+      owned.back()->pool = this;
+      sinks[index].store(owned.back().get(), std::memory_order_relaxed);
+      sink_count.store(index + 1, std::memory_order_release);
+      return owned.back().get();
+    }
+
+    AsyncSink* add_sink(std::ostream& output,
+      Backpressure backpressure = Backpressure::Block,
+      size_t capacity = 4096)
+    {
+      return add_sink([&output](std::string_view text) {
+        output.write(text.data(), text.size());
+      }, backpressure, capacity);
+    }
+
+    // Waits until all calls queued so far are written
+    void flush() {
+      const size_t count = sink_count.load(std::memory_order_acquire);
+      for(size_t i = 0; i < count; i++) {
+        while(!sinks[i].load(std::memory_order_relaxed)->idle())
+          std::this_thread::yield();
+      }
+    }
+
+    // Called after a call is queued
+    inline void notify() {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if(sleeping.load(std::memory_order_relaxed))
+        wake();
+    }
+
+  private:
+    inline void wake() {
+      generation.fetch_add(1, std::memory_order_release);
+      generation.notify_all();
+    }
+
+    // Starts at its own sink and takes any other that has work
+    inline bool run_once(size_t worker, std::string& buffer) {
+      const size_t count = sink_count.load(std::memory_order_acquire);
+      bool any = false;
+      for(size_t i = 0; i < count; i++) {
+        AsyncSink* sink = sinks[(worker + i) % count].load(std::memory_order_relaxed);
+        if(sink->try_own())
+          any |= sink->run(buffer, batch) > 0;
+      }
+      return any;
+    }
+
+    void work(size_t worker) {
+      std::string buffer;
+      for(;;) {
+        if(run_once(worker, buffer))
+          continue;
+
+        // Announce sleeping before the last look, such that a call queued
+        // meanwhile sees it and wakes us
+        sleeping.fetch_add(1, std::memory_order_seq_cst);
+        const uint32_t seen = generation.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(run_once(worker, buffer)) {
+          sleeping.fetch_sub(1, std::memory_order_relaxed);
+          continue;
+        }
+        if(stopping.load(std::memory_order_seq_cst)) {
+          sleeping.fetch_sub(1, std::memory_order_relaxed);
+          flush_remaining(worker, buffer);
+          return;
+        }
+        generation.wait(seen, std::memory_order_acquire);
+        sleeping.fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+
+    void flush_remaining(size_t worker, std::string& buffer) {
+      while(run_once(worker, buffer));
+    }
+
+    std::array<std::atomic<AsyncSink*>, max_sinks> sinks{};
+    std::atomic<size_t> sink_count{0};
+    std::vector<std::unique_ptr<AsyncSink>> owned;
+    std::mutex adding;
+
+    std::vector<std::thread> threads;
+    alignas(64) std::atomic<uint32_t> generation{0};
+    std::atomic<uint32_t> sleeping{0};
+    std::atomic<bool> stopping{false};
+  };
+
+  /* Copies the arguments and queues the call to be formatted by a worker.
+   * Returns false if it was discarded because the queue was full.
+   */
+  template<typename Format, typename ... Arguments>
+  bool async_write(
+    Format& format_string,
+    AsyncSink& output,
+    Arguments&&... arguments)
+  {
+    using Call = internal::AsyncCall<Format, Arguments...>;
+
+    internal::AsyncCell* cell;
+    size_t position;
+    while(!(cell = output.claim(position))) {
+      switch(output.backpressure) {
+      case Backpressure::Count:
+        output.dropped_calls.fetch_add(1, std::memory_order_relaxed);
+        [[fallthrough]];
+      case Backpressure::Drop:
+        return false;
+      case Backpressure::Block:
+        output.pool->notify();
+        std::this_thread::yield();
+      }
+    }
+
+    new (cell->arguments) typename Call::Captured{internal::async_copy(std::forward<Arguments>(arguments))...};
+    cell->run = &Call::run;
+    cell->sequence.store(position + 1, std::memory_order_release);
+    output.pool->notify();
+    return true;
+  }
+}
+
+#endif
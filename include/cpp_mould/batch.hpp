@@ -0,0 +1,286 @@
+#ifndef CPP_MOULD_BATCH_HPP
+#define CPP_MOULD_BATCH_HPP
+/* Formatting many records with the same format into one buffer, in
+ * parallel. The records are split into contiguous chunks, one per thread.
+ * A first pass counts the length of each chunk, their prefix sums place
+ * the chunks in the output and a second pass formats each chunk directly
+ * into its place. The output is the same as formatting the records one
+ * after the other.
+ *
+ * Records given as columns, one per argument, are formatted column by
+ * column into staging areas for a block of rows, and the rows are then
+ * assembled from the staged fields and the literals of the format.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "engine.hpp"
+#include "constexpr_driver.hpp"
+#include "arguments/digits.hpp"
+#include "arguments/int.hpp"
+
+namespace mould::internal {
+  // Chunks smaller than this are not worth a thread
+  constexpr size_t batch_min_chunk = 4096;
+
+  inline size_t batch_threads(size_t records, unsigned threads) {
+    if(!threads)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    return std::clamp<size_t>(records/batch_min_chunk, 1, threads);
+  }
+
+  // Runs `work(chunk, begin, end)` for `chunks` even parts of `count`, the
+  // first on the calling thread
+  template<typename Work>
+  void for_each_chunk(size_t count, size_t chunks, Work&& work) {
+    const auto bounds = [=](size_t chunk) { return count*chunk/chunks; };
+    std::vector<std::thread> threads;
+    threads.reserve(chunks - 1);
+    for(size_t chunk = 1; chunk < chunks; chunk++)
+      threads.emplace_back([&work, &bounds, chunk] { work(chunk, bounds(chunk), bounds(chunk + 1)); });
+    work(0, bounds(0), bounds(1));
+    for(auto& thread : threads)
+      thread.join();
+  }
+
+  /* The two passes over chunks of records. `format(engine, index)` formats
+   * the record `index` with the engine.
+   */
+  template<typename Format>
+  void format_chunks(size_t count, std::string& output, unsigned threads, Format&& format) {
+    const size_t chunks = batch_threads(count, threads);
+    std::vector<size_t> offsets(chunks + 1);
+
+    for_each_chunk(count, chunks, [&](size_t chunk, size_t begin, size_t end) {
+      CountingEngine engine;
+      for(size_t index = begin; index < end; index++)
+        format(engine, index);
+      offsets[chunk + 1] = engine.counted();
+    });
+
+    const size_t at = output.size();
+    offsets[0] = at;
+    for(size_t chunk = 0; chunk < chunks; chunk++)
+      offsets[chunk + 1] += offsets[chunk];
+    output.resize(offsets[chunks]);
+
+    // Records write into the remaining space of their chunk with show_buf
+    // and the next record overwrites it, no chunk is touched by two threads
+    char* const data = output.data();
+    for_each_chunk(count, chunks, [&](size_t chunk, size_t begin, size_t end) {
+      SpanEngine engine{data + offsets[chunk], data + offsets[chunk + 1]};
+      for(size_t index = begin; index < end; index++)
+        format(engine, index);
+    });
+  }
+}
+
+namespace mould::internal {
+  // Rows of columns staged at once, such that the stages stay in cache
+  constexpr size_t column_block = 256;
+  // Space of one staged decimal, right aligned
+  constexpr size_t decimal_slot = 32;
+  // Decimals are copied with a fixed length, which may write this far past
+  // the end of the row. The copy also reads past the last slot.
+  constexpr size_t decimal_copy = 24;
+
+  /* Decimals of a column, each right aligned in its slot. Two values below
+   * 10^8 are converted in one vector, larger ones use one vector for their
+   * last 16 digits.
+   */
+  template<typename T>
+  void write_decimal_slots(const T* values, size_t count, char* slots, uint8_t* lengths) {
+    const auto finish = [=](size_t index, uint64_t digits) {
+      unsigned length = count_digits(digits);
+      if(values[index] < 0)
+        slots[(index + 1)*decimal_slot - ++length] = '-';
+      lengths[index] = static_cast<uint8_t>(length);
+    };
+
+    for(size_t index = 0; index < count; index++) {
+      char* const end = slots + (index + 1)*decimal_slot;
+      const uint64_t digits = magnitude(values[index]);
+#if defined(__SSE2__)
+      constexpr uint64_t small = 100000000;
+      if(digits < small && index + 1 < count && magnitude(values[index + 1]) < small) {
+        const uint64_t next = magnitude(values[index + 1]);
+        const __m128i both = decimal_digits16(static_cast<uint32_t>(digits), static_cast<uint32_t>(next));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(end - 8), both);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(end + decimal_slot - 8), _mm_srli_si128(both, 8));
+        finish(index, digits);
+        finish(++index, next);
+        continue;
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(end - 16), decimal_digits16(
+        static_cast<uint32_t>(digits/small % small), static_cast<uint32_t>(digits % small)));
+      if(digits >= small*small)
+        write_fixed_digits(end - 20, digits/(small*small), 4);
+#else
+      write_fixed_digits(end - count_digits(digits), digits, count_digits(digits));
+#endif
+      finish(index, digits);
+    }
+  }
+
+  // A column of int or 64 bit integers in a format that is just the number
+  template<typename T>
+  constexpr bool is_decimal_column(const Formatting& formatting) {
+    if constexpr(std::is_same_v<T, int> || is_wide_integer<T>) {
+      return (formatting.kind == FormatKind::Auto || formatting.kind == FormatKind::decimal)
+        && formatting.width == FormatArgument::Auto && formatting.precision == FormatArgument::Auto
+        && formatting.padding == FormatArgument::Auto && formatting.sign == Sign::Default
+        && formatting.grouping == Grouping::None;
+    } else {
+      return false;
+    }
+  }
+
+  template<typename Expression>
+  struct ColumnStage;
+
+  template<>
+  struct ColumnStage<constexpr_driver::LiteralExpression> {
+    template<typename Format, size_t Index, typename ... Values>
+    struct For {
+      constexpr static auto& expression = std::get<Index>(
+        constexpr_driver::CompiledExpressions<Format, Values...>.expressions);
+
+      void stage(size_t, size_t, const Values* ...) { }
+
+      size_t length(size_t rows) const {
+        return expression.length*rows;
+      }
+
+      char* copy(char* out, size_t) const {
+        std::memcpy(out, Format::data.format_buffer().begin() + expression.offset, expression.length);
+        return out + expression.length;
+      }
+    };
+  };
+
+  template<typename T>
+  struct ColumnStage<constexpr_driver::TypedArgumentExpression<T>> {
+    template<typename Format, size_t Index, typename ... Values>
+    struct For {
+      constexpr static auto& expression = std::get<Index>(
+        constexpr_driver::CompiledExpressions<Format, Values...>.expressions);
+      constexpr static int argument = constexpr_driver::ExpressionData<Format, Values...>.indices[Index];
+      constexpr static bool decimal = is_decimal_column<T>(expression.operation.formatting);
+
+      // Decimals in slots, or the text of each field and where it ends
+      std::unique_ptr<char[]> slots{decimal ? new char[column_block*decimal_slot + decimal_copy] : nullptr};
+      uint8_t lengths[decimal ? column_block : 1];
+      std::string text;
+      uint32_t ends[decimal ? 1 : column_block];
+
+      void stage(size_t begin, size_t end, const Values* ... columns) {
+        if constexpr(decimal) {
+          const T* column = std::get<argument>(std::make_tuple(columns...));
+          write_decimal_slots(column + begin, end - begin, slots.get(), lengths);
+        } else {
+          using namespace constexpr_driver;
+          text.clear();
+          StringEngine engine{text};
+          const ExpressionContext<StringEngine> context{engine, Format::data.format_buffer()};
+          for(size_t row = begin; row < end; row++) {
+            Eval<StringEngine, TypedArgumentExpression<T>>::template evaluate<Format, Index>(context, columns[row]...);
+            ends[row - begin] = static_cast<uint32_t>(text.size());
+          }
+        }
+      }
+
+      size_t length(size_t rows) const {
+        if constexpr(decimal) {
+          size_t total = 0;
+          for(size_t row = 0; row < rows; row++)
+            total += lengths[row];
+          return total;
+        } else {
+          return text.size();
+        }
+      }
+
+      char* copy(char* out, size_t row) const {
+        if constexpr(decimal) {
+          const size_t length = lengths[row];
+          std::memcpy(out, slots.get() + (row + 1)*decimal_slot - length, decimal_copy);
+          return out + length;
+        } else {
+          const size_t begin = row ? ends[row - 1] : 0;
+          std::memcpy(out, text.data() + begin, ends[row] - begin);
+          return out + (ends[row] - begin);
+        }
+      }
+    };
+  };
+
+  template<typename Format, typename ... Values, size_t ... Indices>
+  void format_column_blocks(std::string& output, size_t rows, std::index_sequence<Indices...>, const Values* ... columns) {
+    using Compiled = decltype(constexpr_driver::CompiledExpressions<Format, Values...>);
+    std::tuple<typename ColumnStage<typename Compiled::template ExpressionType<Indices>>
+      ::template For<Format, Indices, Values...> ...> stages;
+
+    for(size_t begin = 0; begin < rows; begin += column_block) {
+      const size_t end = std::min(rows, begin + column_block);
+      (std::get<Indices>(stages).stage(begin, end, columns...), ...);
+
+      const size_t at = output.size();
+      const size_t length = (0 + ... + std::get<Indices>(stages).length(end - begin));
+      output.resize(at + length + decimal_copy);
+      char* out = output.data() + at;
+      for(size_t row = 0; row < end - begin; row++)
+        ((out = std::get<Indices>(stages).copy(out, row)), ...);
+      output.resize(at + length);
+    }
+  }
+}
+
+namespace mould {
+  /* Appends all `records`, a contiguous range of tuples of the arguments,
+   * formatted with the format. `threads` limits the number of threads,
+   * 0 for one per core.
+   */
+  template<typename Format, typename Records>
+  void format_batch(
+    Format& format_string,
+    const Records& records,
+    std::string& output,
+    unsigned threads = 0)
+  {
+    using namespace internal::constexpr_driver;
+
+    const auto* data = std::data(records);
+    internal::format_chunks(std::size(records), output, threads,
+      [data](auto& engine, size_t index) {
+        std::apply([&engine](const auto& ... arguments) {
+          eval<Format>(engine, arguments...);
+        }, data[index]);
+      });
+  }
+
+  /* Appends the rows of `columns`, one contiguous range per argument of the
+   * format, all of the same length. Fields that are just an int or 64 bit
+   * integer are converted with vector kernels, all others with their
+   * formatter, column by column.
+   */
+  template<typename Format, typename ... Columns>
+  void format_columns(
+    Format& format_string,
+    std::string& output,
+    const Columns& ... columns)
+  {
+    static_assert(sizeof...(Columns) > 0, "Rows need at least one column");
+    internal::register_format<Format, std::remove_cvref_t<decltype(*std::data(columns))>...>();
+    const size_t rows = std::min({ std::size(columns) ... });
+    internal::format_column_blocks<Format>(output, rows,
+      std::make_index_sequence<std::size(Format::data.code)>{}, std::data(columns)...);
+  }
+}
+
+#endif
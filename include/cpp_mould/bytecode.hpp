@@ -51,8 +51,17 @@ namespace mould::internal {
     WHAT(EXPONENT)\
     WHAT(fpoint)\
     WHAT(FPOINT)\
+    WHAT(general)\
+    WHAT(GENERAL)\
     WHAT(pointer)\
-    WHAT(string)
+    WHAT(string)\
+    WHAT(json)\
+    WHAT(quoted)\
+    WHAT(hexdump)\
+    WHAT(base64)\
+    WHAT(percent)\
+    WHAT(bytesize)\
+    WHAT(timespan)
 
   enum struct FormatKind: unsigned char {
     Auto     = 0, /* The kind is automatically chosen by the parameter */
@@ -70,6 +79,19 @@ namespace mould::internal {
 
     string    = 11,
     character = 12,
+
+    general   = 13,
+    GENERAL   = 14,
+
+    json      = 15, /* A string with JSON escapes, in double quotes */
+    quoted    = 16, /* A string with C escapes, in double quotes */
+
+    hexdump   = 17, /* Bytes as hex in groups of `precision` */
+    base64    = 18,
+
+    percent   = 19, /* Fixed notation of a hundred times the value, with '%' */
+    bytesize  = 20, /* A number of bytes with a binary unit, as 1.5 KiB */
+    timespan  = 21, /* A number of nanoseconds with a unit, as 12.3 ms */
   };
 
   enum struct InlineValue: unsigned char {
@@ -92,9 +114,15 @@ namespace mould::internal {
     Pad     = 2,
   };
 
+  enum struct Grouping: unsigned char {
+    None       = 0,
+    Comma      = 1,
+    Underscore = 2,
+  };
+
   struct FormatDescription {
     /* If everything is auto , this is encoded in the opcode */
-    FormatKind  kind;      /* 4 bits */
+    FormatKind  kind;      /* 8 bits */
 
     InlineValue width;     /* 2 bits */
     InlineValue precision; /* 2 bits */
@@ -105,12 +133,17 @@ namespace mould::internal {
 
     Sign        sign; /* 2 bits */
 
-    InlineValue index;     /* 1.5 bits, immediate not allowed */
-    // 16 bit used.
+    InlineValue index;     /* 1.5 bits, immediate not allowed, parameter for a name */
+
+    /* Trailing spec text after '|', offset and length are immediates */
+    bool        extension; /* 1 bit */
+
+    Grouping    grouping;  /* 2 bits */
+    // 23 bit used, 1 bit reserved.
 
-    // 6 inline values (48 bit) for all kinds of fancy stuff.
-    // TODO: only 2 this for 32bit systems.
-    unsigned char inlines[6];
+    // 5 inline values (40 bit) for all kinds of fancy stuff.
+    // TODO: only 1 this for 32bit systems.
+    unsigned char inlines[5];
 
     static constexpr FormatDescription Uninitialized() {
       return FormatDescription {
@@ -121,6 +154,8 @@ namespace mould::internal {
         Alignment::Default,
         Sign::Default,
         InlineValue::Auto,
+        false,
+        Grouping::None,
         {}
       };
     }
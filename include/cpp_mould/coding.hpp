@@ -88,16 +88,18 @@ namespace mould::internal {
     constexpr EncodedFormatDescription(FormatDescription format)
       : encoded(0)
     {
-      for(int i = 5; i >= 0; i--) encoded = (encoded << 8)|format.inlines[i];
-      encoded = encoded << 16;
-
-      encoded |= (static_cast<unsigned char>(format.kind) & Immediate{0xF});
-      encoded |= (static_cast<unsigned char>(format.width) & Immediate{0x3}) << 4;
-      encoded |= (static_cast<unsigned char>(format.precision) & Immediate{0x3}) << 6;
-      encoded |= (static_cast<unsigned char>(format.padding) & Immediate{0x3}) << 8;
-      encoded |= (static_cast<unsigned char>(format.alignment) & Immediate{0x3}) << 10;
-      encoded |= (static_cast<unsigned char>(format.sign) & Immediate{0x3}) << 12;
-      encoded |= (static_cast<unsigned char>(format.index) & Immediate{0x3}) << 14;
+      for(int i = 4; i >= 0; i--) encoded = (encoded << 8)|format.inlines[i];
+      encoded = encoded << 24;
+
+      encoded |= (static_cast<unsigned char>(format.kind) & Immediate{0xFF});
+      encoded |= (static_cast<unsigned char>(format.width) & Immediate{0x3}) << 8;
+      encoded |= (static_cast<unsigned char>(format.precision) & Immediate{0x3}) << 10;
+      encoded |= (static_cast<unsigned char>(format.padding) & Immediate{0x3}) << 12;
+      encoded |= (static_cast<unsigned char>(format.alignment) & Immediate{0x3}) << 14;
+      encoded |= (static_cast<unsigned char>(format.sign) & Immediate{0x3}) << 16;
+      encoded |= (static_cast<unsigned char>(format.index) & Immediate{0x3}) << 18;
+      encoded |= (format.extension ? Immediate{1} : Immediate{0}) << 20;
+      encoded |= (static_cast<unsigned char>(format.grouping) & Immediate{0x3}) << 21;
     }
 
     constexpr FormatDescription FullDescription() const {
@@ -109,41 +111,51 @@ namespace mould::internal {
       description.alignment = alignment();
       description.sign = sign();
       description.index = index();
+      description.extension = extension();
+      description.grouping = grouping();
 
-      for(int i = 0; i < 6; i++) description.inlines[i] = inline_value(i);
+      for(int i = 0; i < 5; i++) description.inlines[i] = inline_value(i);
       return description;
     }
 
     constexpr FormatKind kind() const {
-      return static_cast<FormatKind>(encoded & 0xF);
+      return static_cast<FormatKind>(encoded & 0xFF);
     }
 
     constexpr InlineValue width() const {
-      return static_cast<InlineValue>((encoded >> 4) & 0x3);
+      return static_cast<InlineValue>((encoded >> 8) & 0x3);
     }
 
     constexpr InlineValue precision() const {
-      return static_cast<InlineValue>((encoded >> 6) & 0x3);
+      return static_cast<InlineValue>((encoded >> 10) & 0x3);
     }
 
     constexpr InlineValue padding() const {
-      return static_cast<InlineValue>((encoded >> 8) & 0x3);
+      return static_cast<InlineValue>((encoded >> 12) & 0x3);
     }
 
     constexpr Alignment alignment() const {
-      return static_cast<Alignment>((encoded >> 10) & 0x3);
+      return static_cast<Alignment>((encoded >> 14) & 0x3);
     }
 
     constexpr Sign sign() const {
-      return static_cast<Sign>((encoded >> 12) & 0x3);
+      return static_cast<Sign>((encoded >> 16) & 0x3);
     }
 
     constexpr InlineValue index() const {
-      return static_cast<InlineValue>((encoded >> 14) & 0x3);
+      return static_cast<InlineValue>((encoded >> 18) & 0x3);
+    }
+
+    constexpr bool extension() const {
+      return (encoded >> 20) & 0x1;
+    }
+
+    constexpr Grouping grouping() const {
+      return static_cast<Grouping>((encoded >> 21) & 0x3);
     }
 
     constexpr unsigned char inline_value(unsigned char index) const {
-      return static_cast<unsigned char>((encoded >> (16 + 8*index)) & 0xFF);
+      return static_cast<unsigned char>((encoded >> (24 + 8*index)) & 0xFF);
     }
 
     friend constexpr bool operator<<(
@@ -172,13 +184,15 @@ namespace mould::internal {
     MissingWidth,
     MissingPrecision,
     MissingPadding,
+    MissingExtension,
+    MissingName,
     InvalidIndex,
     InvalidOpcode,
     InvalidFormatImmediate,
   };
 
   struct EncodedFormatting {
-    Immediate _immediates[4];
+    Immediate _immediates[8];
     unsigned char used_immediates;
 
     constexpr void append_immediate(Immediate value) {
@@ -225,6 +239,18 @@ namespace mould::internal {
     Parameter,
   };
 
+  // The value of a Parameter without an index, it takes the next argument
+  constexpr Immediate auto_parameter = 0xff;
+
+  // The character between groups of digits, 0 for none
+  constexpr char grouping_separator(Grouping grouping) {
+    switch(grouping) {
+    case Grouping::Comma: return ',';
+    case Grouping::Underscore: return '_';
+    default: return 0;
+    }
+  }
+
   struct Formatting {
     FormatKind kind;
 
@@ -233,17 +259,30 @@ namespace mould::internal {
     FormatArgument padding;
     Alignment alignment;
     Sign sign;
-    FormatArgument index;
+    FormatArgument index /* Parameter for an argument given by name */;
+    FormatArgument extension /* Auto or Value */;
+    Grouping grouping;
 
     Immediate width_value;
     Immediate precision_value;
     Immediate padding_value;
     Codepoint index_value;
 
+    // Position of the extension text in the format string
+    Immediate extension_offset;
+    Immediate extension_length;
+
+    // Position of the argument name in the format string
+    Immediate name_offset;
+    Immediate name_length;
+
     constexpr Formatting()
       : kind(FormatKind::Auto), width(FormatArgument::Auto), precision(FormatArgument::Auto),
       padding(FormatArgument::Auto), alignment(Alignment::Default), sign(Sign::Default),
-      index(FormatArgument::Auto), width_value(), precision_value(), padding_value(), index_value()
+      index(FormatArgument::Auto), extension(FormatArgument::Auto),
+      grouping(Grouping::None), width_value(),
+      precision_value(), padding_value(), index_value(), extension_offset(), extension_length(),
+      name_offset(), name_length()
     { }
 
     constexpr static InlineValue _determine_value_kind(FormatArgument arg, Immediate value) {
@@ -283,7 +322,10 @@ namespace mould::internal {
 
       final_format.alignment = alignment;
       final_format.sign = sign;
-      final_format.index = index == FormatArgument::Auto ? InlineValue::Auto : InlineValue::Inline;
+      final_format.index = index == FormatArgument::Auto ? InlineValue::Auto
+        : index == FormatArgument::Value ? InlineValue::Inline : InlineValue::Parameter;
+      final_format.extension = extension != FormatArgument::Auto;
+      final_format.grouping = grouping;
 
       unsigned char used_inlines = 0;
 
@@ -294,7 +336,7 @@ namespace mould::internal {
       if(final_format.padding == InlineValue::Inline || final_format.padding == InlineValue::Parameter)
         final_format.inlines[used_inlines++] = (Codepoint) padding_value;
 
-      if(final_format.index == InlineValue::Inline /* Parameter is not (yet) allowed */)
+      if(final_format.index == InlineValue::Inline)
         final_format.inlines[used_inlines++] = index_value;
 
       EncodedFormatting compressed = {};
@@ -308,6 +350,14 @@ namespace mould::internal {
         compressed.append_immediate(precision_value);
       if(final_format.padding == InlineValue::Immediate)
         compressed.append_immediate(padding_value);
+      if(final_format.extension) {
+        compressed.append_immediate(extension_offset);
+        compressed.append_immediate(extension_length);
+      }
+      if(final_format.index == InlineValue::Parameter) {
+        compressed.append_immediate(name_offset);
+        compressed.append_immediate(name_length);
+      }
 
       return compressed;
     }
@@ -328,6 +378,7 @@ namespace mould::internal {
       decoded.kind = decoded_format.kind;
       decoded.sign = decoded_format.sign;
       decoded.alignment = decoded_format.alignment;
+      decoded.grouping = decoded_format.grouping;
 
       decoded.width = _determine_argument_kind(decoded_format.width);
       switch(decoded_format.width) {
@@ -373,11 +424,27 @@ namespace mould::internal {
       case InlineValue::Inline:
         decoded.index_value = format.inline_value(inline_index++);
       case InlineValue::Auto:
+      case InlineValue::Parameter:
         break;
       default:
         return ReadStatus::InvalidIndex;
       }
 
+      if(decoded_format.extension) {
+        decoded.extension = FormatArgument::Value;
+        if(!(immediates >> decoded.extension_offset))
+          return ReadStatus::MissingExtension;
+        if(!(immediates >> decoded.extension_length))
+          return ReadStatus::MissingExtension;
+      }
+
+      if(decoded.index == FormatArgument::Parameter) {
+        if(!(immediates >> decoded.name_offset))
+          return ReadStatus::MissingName;
+        if(!(immediates >> decoded.name_length))
+          return ReadStatus::MissingName;
+      }
+
       target = decoded;
       return ReadStatus::NoError;
     }
@@ -433,6 +500,15 @@ namespace mould::internal {
 
     constexpr FullOperation operator*();
     constexpr FullOperationIterator& operator++();
+
+    constexpr void resolve_parameter(FormatArgument kind, Immediate& value) {
+      if(kind != FormatArgument::Parameter)
+        return;
+      if(value == auto_parameter)
+        value = auto_index++;
+      else
+        auto_index = std::max<int>(auto_index, value + 1);
+    }
   };
 
   constexpr FullOperationIterator& FullOperationIterator::operator++() {
@@ -449,12 +525,20 @@ namespace mould::internal {
 
     switch(latest.operation.operation.type) {
     case OpCode::Insert:
-      if((status = imm_buffer >> latest.formatting) != ReadStatus::NoError)
+      // An insert without format immediates uses the default formatting.
+      if(latest.operation.operation.insert_format == ImmediateValue::Auto)
+        latest.formatting = Formatting{};
+      else if((status = imm_buffer >> latest.formatting) != ReadStatus::NoError)
         return latest;
+      // A named argument is found by the driver and takes no automatic index
       if(latest.formatting.index == FormatArgument::Auto)
         latest.formatting.index_value = auto_index++;
-      else
+      else if(latest.formatting.index == FormatArgument::Value)
         auto_index = std::max(auto_index, latest.formatting.index_value + 1);
+      // Nested fields follow their field, in the order of the format text
+      resolve_parameter(latest.formatting.padding, latest.formatting.padding_value);
+      resolve_parameter(latest.formatting.width, latest.formatting.width_value);
+      resolve_parameter(latest.formatting.precision, latest.formatting.precision_value);
       break;
     case OpCode::Literal:
       if((status = imm_buffer >> latest.literal) != ReadStatus::NoError)
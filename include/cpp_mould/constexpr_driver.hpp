@@ -5,6 +5,9 @@
 #include "engine.hpp"
 #include "format.hpp"
 #include "format_info.hpp"
+#include "named.hpp"
+#include "registry.hpp"
+#include "runtime_driver.hpp"
 
 namespace mould::internal::constexpr_driver {
   /* Resolved expression representation */
@@ -33,7 +36,9 @@ namespace mould::internal::constexpr_driver {
     }
   };
 
-  template<typename T>
+  // Named and positional fields are resolved here, to the position of their
+  // argument
+  template<typename T, typename ... Arguments>
   constexpr auto _expression_data()
   -> ExpressionInformation<std::size(T::data.code)> {
     ExpressionInformation<std::size(T::data.code)> result = {{}};
@@ -43,8 +48,11 @@ namespace mould::internal::constexpr_driver {
 
     while(!iterator.code_buffer.empty()) {
       auto op = *iterator;
-      if(op.operation.operation.type == OpCode::Insert) {
-        *output_ptr++ = op.formatting.index_value;
+      if(op.operation.operation.type == OpCode::Insert && op.formatting.index == FormatArgument::Parameter) {
+        *output_ptr++ = named_index<Arguments...>({
+          T::data.format_string.begin() + op.formatting.name_offset, op.formatting.name_length});
+      } else if(op.operation.operation.type == OpCode::Insert) {
+        *output_ptr++ = positional_index<Arguments...>(op.formatting.index_value);
       } else {
         *output_ptr++ = -1;
       }
@@ -53,8 +61,8 @@ namespace mould::internal::constexpr_driver {
     return result;
   }
 
-  template<typename T>
-  constexpr auto ExpressionData = _expression_data<T>();
+  template<typename T, typename ... Arguments>
+  constexpr auto ExpressionData = _expression_data<T, Arguments...>();
 
   /* Compile the useful data, retrieve the specific formatting functions */
   template<int Index, typename ArgsTuple>
@@ -62,7 +70,9 @@ namespace mould::internal::constexpr_driver {
     if constexpr(Index < 0) {
       return LiteralExpression { 0, 0 };
     } else {
-      using type = typename std::tuple_element<Index, ArgsTuple>::type;
+      static_assert(Index < std::tuple_size_v<ArgsTuple>, "A field of the format has no argument. "
+        "Positional fields skip named arguments, and a single letter such as `{x}` is a kind, `{x:}` a name");
+      using type = named_type<typename std::tuple_element<Index, ArgsTuple>::type>;
       return TypedArgumentExpression<type> { Index, nullptr };
     }
   }
@@ -87,14 +97,14 @@ namespace mould::internal::constexpr_driver {
     return CompiledFormatExpressions<E...>::Compile(expressions.initialize(*iterator) ...);
   }
 
-  template<typename T, typename ArgsTuple, size_t ... indices>
+  template<typename T, typename ... Arguments, size_t ... indices>
   constexpr auto build_expressions(std::index_sequence<indices...>) {
-    auto& data = ExpressionData<T>;
-    return initialize<T>(uninitialized_expression<data.indices[indices], ArgsTuple>() ...);
+    auto& data = ExpressionData<T, Arguments...>;
+    return initialize<T>(uninitialized_expression<data.indices[indices], std::tuple<Arguments...>>() ...);
   }
 
   template<typename Format, typename ... Arguments>
-  constexpr auto CompiledExpressions = build_expressions<Format, std::tuple<Arguments...>>(
+  constexpr auto CompiledExpressions = build_expressions<Format, Arguments...>(
     std::make_index_sequence<std::size(Format::data.code)>{});
 
   /* Run the engine with arguments */
@@ -112,7 +122,7 @@ namespace mould::internal::constexpr_driver {
     template<typename Format, size_t index, typename ... Arguments>
     static inline auto evaluate(
       const ExpressionContext<EngineImpl>& context,
-      Arguments& ... args) 
+      const Arguments& ... args) 
     {
       constexpr auto& expression = std::get<index>(CompiledExpressions<Format, Arguments...>.expressions);
       // This is going to be determined at compile time, so the switch actually
@@ -130,26 +140,87 @@ namespace mould::internal::constexpr_driver {
   };
 
   template<FormatArgument type, Immediate value, typename ... Arguments>
-  constexpr Immediate get_value(const Arguments& ... args) {
+  inline Immediate get_value(const Arguments& ... args) {
     if constexpr(type == FormatArgument::Auto) {
       return 0;
     } else if constexpr(type == FormatArgument::Parameter) {
-      return std::get<value>(std::tie(args...));
+      constexpr size_t index = positional_index<Arguments...>(value);
+      static_assert(index < sizeof...(Arguments), "A nested field of the format has no argument");
+      const auto& argument = std::get<index>(std::tie(args...));
+      static_assert(std::is_integral_v<std::remove_cvref_t<decltype(argument)>>,
+        "A nested field of the format needs an integer or a character");
+      return value_as_immediate(argument);
     } else {
       return value;
     }
   }
 
+  // The format of an insert expression, with the values of its parameters
+  template<typename Format, size_t index, typename ... Arguments>
+  inline ::mould::Format expression_format(Buffer<const char> format_buffer, const Arguments& ... args) {
+    constexpr auto& expression = std::get<index>(CompiledExpressions<Format, Arguments...>.expressions);
+    constexpr auto& formatting = expression.operation.formatting;
+    return {
+      // values
+      get_value<formatting.width, formatting.width_value>(args...),
+      get_value<formatting.precision, formatting.precision_value>(args...),
+      get_value<formatting.padding, formatting.padding_value>(args...),
+
+      // flags
+      formatting.width != FormatArgument::Auto,
+      formatting.precision != FormatArgument::Auto,
+      formatting.padding != FormatArgument::Auto,
+
+      formatting.alignment,
+      formatting.sign,
+      grouping_separator(formatting.grouping),
+
+      std::string_view{
+        format_buffer.begin() + formatting.extension_offset,
+        formatting.extension_length}
+    };
+  }
+
   template<typename EngineImpl, typename T>
   struct Eval<EngineImpl, TypedArgumentExpression<T>> {
     template<typename Format, size_t index, typename ... Arguments>
     static inline auto evaluate(
       const ExpressionContext<EngineImpl>& context,
-      Arguments& ... args)
+      const Arguments& ... args)
+    {
+      constexpr auto& expression = std::get<index>(CompiledExpressions<Format, Arguments...>.expressions);
+      format_with<Format, index, expression.function>(context,
+        expression_format<Format, index>(context.format_buffer, args...), args...);
+    }
+
+    /* Formats with a format given by the caller, such as one with another
+     * width. The function of the expression may be specialized to the
+     * compiled format, the formatter of the kind takes any format.
+     */
+    template<typename Format, size_t index, typename ... Arguments>
+    static inline auto evaluate_with(
+      const ExpressionContext<EngineImpl>& context,
+      const ::mould::Format& format,
+      const Arguments& ... args)
+    {
+      constexpr auto& expression = std::get<index>(CompiledExpressions<Format, Arguments...>.expressions);
+      constexpr auto generic = [] {
+        FullOperation operation = {};
+        operation.formatting.kind = expression.operation.formatting.kind;
+        return TypedFormatter<T>::get(operation).function;
+      }();
+      format_with<Format, index, generic>(context, format, args...);
+    }
+
+  private:
+    template<typename Format, size_t index, auto fn, typename ... Arguments>
+    static inline auto format_with(
+      const ExpressionContext<EngineImpl>& context,
+      const ::mould::Format& format,
+      const Arguments& ... args)
     {
       constexpr auto& expression = std::get<index>(CompiledExpressions<Format, Arguments...>.expressions);
       constexpr auto& formatting = expression.operation.formatting;
-      constexpr auto fn = expression.function;
 #define CPP_MOULD_CONSTEXPR_EVAL_ASSERT(fkind) \
       if constexpr(formatting.kind == FormatKind:: fkind) { \
         static_assert(fn != nullptr, "Requested formatting (" #fkind ") not implemented"); \
@@ -158,21 +229,7 @@ namespace mould::internal::constexpr_driver {
       CPP_MOULD_CONSTEXPR_EVAL_ASSERT(Auto)
       CPP_MOULD_REPEAT_FOR_FORMAT_KINDS_MACRO(CPP_MOULD_CONSTEXPR_EVAL_ASSERT)
 #undef CPP_MOULD_CONSTEXPR_EVAL_ASSERT
-      const auto& argument = std::get<ExpressionData<Format>.indices[index]>(std::tie(args...));
-      ::mould::Format format {
-        // values
-        get_value<formatting.width, formatting.width_value>(args...),
-        get_value<formatting.precision, formatting.precision_value>(args...),
-        get_value<formatting.padding, formatting.padding_value>(args...),
-
-        // flags
-        formatting.width != FormatArgument::Auto,
-        formatting.precision != FormatArgument::Auto,
-        formatting.padding != FormatArgument::Auto,
-
-        formatting.alignment,
-        formatting.sign
-      };
+      const auto& argument = named_value(std::get<ExpressionData<Format, Arguments...>.indices[index]>(std::tie(args...)));
       fn(argument, ::mould::Formatter{context.engine, format});
     }
   };
@@ -183,15 +240,18 @@ namespace mould::internal::constexpr_driver {
   };
 
   template<typename EngineImpl, typename Format, typename ... Arguments, size_t ... Indices>
-  inline auto _eval(ExpressionContext<EngineImpl> context, std::index_sequence<Indices...>, Arguments& ... args) {
+  inline auto _eval(ExpressionContext<EngineImpl> context, std::index_sequence<Indices...>, const Arguments& ... args) {
     using Compiled = decltype(CompiledExpressions<Format, Arguments...>);
     Ignore ignore{(Eval<EngineImpl, typename Compiled::template ExpressionType<Indices>>
         ::template evaluate<Format, Indices>(context, args...), 0
       ) ...};
   }
 
+  // Arguments are passed by reference all the way to their formatter, strings
+  // and other large arguments are never copied.
   template<typename Format, typename EngineImpl, typename ... Arguments>
-  inline auto eval(EngineImpl engine, Arguments ... args) {
+  inline auto eval(EngineImpl& engine, const Arguments& ... args) {
+    register_format<Format, Arguments...>();
     ExpressionContext<EngineImpl> context {
       engine,
       Format::data.format_buffer()
@@ -25,6 +25,8 @@ namespace mould::internal {
     case ReadStatus::MissingWidth: return "MissingWidth";
     case ReadStatus::MissingPrecision: return "MissingPrecision";
     case ReadStatus::MissingPadding: return "MissingPadding";
+    case ReadStatus::MissingExtension: return "MissingExtension";
+    case ReadStatus::MissingName: return "MissingName";
     case ReadStatus::InvalidIndex: return "InvalidIndex";
     case ReadStatus::InvalidOpcode: return "InvalidOpcode";
     case ReadStatus::InvalidFormatImmediate: return "InvalidFormatImmediate";
@@ -0,0 +1,296 @@
+#ifndef CPP_MOULD_DEFER_HPP
+#define CPP_MOULD_DEFER_HPP
+/* Deferred formatting: the arguments are copied into a binary record now
+ * and formatted later, possibly on another thread, by the runtime driver.
+ *
+ * A record is the total length (4 bytes), the id of the format and argument
+ * types in the registry (8 bytes), then each argument in order.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "compile.hpp"
+#include "registry.hpp"
+#include "runtime_driver.hpp"
+
+namespace mould::internal {
+  // Views refer to memory of the caller, only a specialization that copies
+  // what they refer to can defer them
+  template<typename T>
+  constexpr bool is_view = false;
+
+  template<typename T, size_t E>
+  constexpr bool is_view<std::span<T, E>> = true;
+
+  template<typename CharT, typename Traits>
+  constexpr bool is_view<std::basic_string_view<CharT, Traits>> = true;
+
+  template<typename T>
+  constexpr bool is_view<std::reference_wrapper<T>> = true;
+
+  // Copied bit by bit, a pointer other than a string is formatted as address
+  template<typename T>
+  constexpr bool is_plain_deferred = std::is_trivially_copyable_v<T> && !std::is_array_v<T>
+    && !std::is_same_v<std::decay_t<T>, char*> && !std::is_same_v<std::decay_t<T>, const char*>
+    && !is_view<T> && !is_named_argument<T>;
+}
+
+namespace mould {
+  /* Specialization point for the binary copy of an argument. `decoded` is
+   * the type read from the record, it may point into the record. An
+   * optional `argument(const decoded&)` gives the value to format instead.
+   */
+  template<typename T, typename = void>
+  struct DeferredArgument;
+
+  // Plain values are copied as they are
+  template<typename T>
+  struct DeferredArgument<T, std::enable_if_t<internal::is_plain_deferred<T>>> {
+    using decoded = T;
+
+    constexpr static size_t size(const T&) { return sizeof(T); }
+
+    static char* write(char* out, const T& value) {
+      std::memcpy(out, &value, sizeof(T));
+      return out + sizeof(T);
+    }
+
+    static decoded read(const char*& in) {
+      decoded value;
+      std::memcpy(&value, in, sizeof(T));
+      in += sizeof(T);
+      return value;
+    }
+  };
+
+  // Strings are copied with their length and read as a view of the record
+  struct DeferredString {
+    using decoded = std::string_view;
+
+    static size_t size(std::string_view value) { return sizeof(uint32_t) + value.size(); }
+
+    static char* write(char* out, std::string_view value) {
+      const auto length = static_cast<uint32_t>(value.size());
+      std::memcpy(out, &length, sizeof(length));
+      std::memcpy(out + sizeof(length), value.data(), length);
+      return out + sizeof(length) + length;
+    }
+
+    static decoded read(const char*& in) {
+      uint32_t length;
+      std::memcpy(&length, in, sizeof(length));
+      const std::string_view value{in + sizeof(length), length};
+      in += sizeof(length) + length;
+      return value;
+    }
+  };
+
+  // Spans are copied with their elements, read into an owning buffer and
+  // formatted as span of it
+  template<typename T, size_t E>
+  struct DeferredArgument<std::span<T, E>, std::enable_if_t<
+      internal::is_plain_deferred<std::remove_const_t<T>> && !std::is_pointer_v<T>>> {
+    using element = std::remove_const_t<T>;
+    using decoded = std::vector<element>;
+
+    static size_t size(std::span<T, E> value) { return sizeof(uint32_t) + value.size_bytes(); }
+
+    static char* write(char* out, std::span<T, E> value) {
+      const auto count = static_cast<uint32_t>(value.size());
+      std::memcpy(out, &count, sizeof(count));
+      if(count)
+        std::memcpy(out + sizeof(count), value.data(), value.size_bytes());
+      return out + sizeof(count) + value.size_bytes();
+    }
+
+    static decoded read(const char*& in) {
+      uint32_t count;
+      std::memcpy(&count, in, sizeof(count));
+      decoded value(count);
+      if(count)
+        std::memcpy(value.data(), in + sizeof(count), count*sizeof(element));
+      in += sizeof(count) + count*sizeof(element);
+      return value;
+    }
+
+    static std::span<const element> argument(const decoded& value) {
+      return value;
+    }
+  };
+
+  template<>
+  struct DeferredArgument<std::string>: DeferredString { };
+
+  template<>
+  struct DeferredArgument<std::string_view>: DeferredString { };
+
+  template<>
+  struct DeferredArgument<const char*>: DeferredString { };
+
+  template<>
+  struct DeferredArgument<char*>: DeferredString { };
+
+  // Literals and buffers, up to the first 0 as for the formatter
+  template<size_t N>
+  struct DeferredArgument<char[N]>: DeferredString {
+    static std::string_view view(const char (&value)[N]) {
+      return { value, static_cast<size_t>(std::find(value, value + N, '\0') - value) };
+    }
+
+    static size_t size(const char (&value)[N]) { return DeferredString::size(view(value)); }
+
+    static char* write(char* out, const char (&value)[N]) {
+      return DeferredString::write(out, view(value));
+    }
+  };
+}
+
+namespace mould {
+  // The value is copied, the name is kept in the type
+  template<FixedName Name, typename T>
+  struct DeferredArgument<NamedArgument<Name, T>> {
+    using value = DeferredArgument<std::remove_cvref_t<T>>;
+    using decoded = NamedArgument<Name, typename value::decoded>;
+
+    static size_t size(const NamedArgument<Name, T>& argument) { return value::size(argument.value); }
+
+    static char* write(char* out, const NamedArgument<Name, T>& argument) {
+      return value::write(out, argument.value);
+    }
+
+    static decoded read(const char*& in) {
+      return { value::read(in) };
+    }
+  };
+}
+
+namespace mould::internal {
+  constexpr size_t deferred_header_size = sizeof(uint32_t) + sizeof(uint64_t);
+
+  template<typename T>
+  using deferred_argument = DeferredArgument<std::remove_cv_t<T>>;
+
+  template<typename T, typename = void>
+  constexpr bool is_deferrable = false;
+
+  template<typename T>
+  constexpr bool is_deferrable<T, std::void_t<typename deferred_argument<T>::decoded>> = true;
+
+  // The value given to the formatter for a decoded argument
+  template<typename T>
+  decltype(auto) deferred_formatted(const typename deferred_argument<T>::decoded& value) {
+    if constexpr(requires { deferred_argument<T>::argument(value); })
+      return deferred_argument<T>::argument(value);
+    else
+      return (value);
+  }
+
+  template<typename Format, typename ... Arguments>
+  struct DeferredDecoder {
+    static bool decode(const char* payload, std::string& output) {
+      // Braced initialization reads the arguments in order
+      const std::tuple<typename deferred_argument<Arguments>::decoded ...> values {
+        deferred_argument<Arguments>::read(payload) ...
+      };
+      return std::apply([&output](const auto& ... values) {
+        return execute(output, deferred_formatted<Arguments>(values) ...);
+      }, values);
+    }
+
+    // The formatted values live until the driver is done
+    template<typename ... Values>
+    static bool execute(std::string& output, const Values& ... values) {
+      const TypeErasedArgument untyped_args[] = { TypeErasedArgument{values} ... };
+      RuntimeDriver driver{output, Format{}, std::begin(untyped_args), std::end(untyped_args)};
+      return driver.execute().type == DriverResultType::Ok;
+    }
+  };
+
+  // Called by `defer`, the registration also decodes the records. The
+  // drivers register the format without a decoder.
+  template<typename Format, typename ... Arguments>
+  inline void register_deferred() {
+    CPP_MOULD_REGISTER((&Registered<Format, &DeferredDecoder<Format, Arguments...>::decode, Arguments...>::entry));
+  }
+}
+
+namespace mould {
+  /* A call captured by reference, written as record by `write`. The size is
+   * known before, such that the caller can reserve the space.
+   */
+  template<typename Format, typename ... Arguments>
+  struct DeferredCall {
+    std::tuple<const Arguments& ...> arguments;
+
+    size_t size() const {
+      return std::apply([](const Arguments& ... values) {
+        return (internal::deferred_header_size + ... + internal::deferred_argument<Arguments>::size(values));
+      }, arguments);
+    }
+
+    static_assert((internal::is_deferrable<Arguments> && ...),
+      "An argument has no DeferredArgument specialization");
+
+    char* write(char* out) const {
+      internal::register_deferred<Format, Arguments...>();
+      const auto length = static_cast<uint32_t>(size());
+      constexpr uint64_t id = internal::format_id<Format, Arguments...>();
+      std::memcpy(out, &length, sizeof(length));
+      std::memcpy(out + sizeof(length), &id, sizeof(id));
+      out += internal::deferred_header_size;
+      return std::apply([out](const Arguments& ... values) mutable {
+        ((out = internal::deferred_argument<Arguments>::write(out, values)), ...);
+        return out;
+      }, arguments);
+    }
+
+    void append_to(std::string& records) const {
+      const size_t at = records.size();
+      records.resize(at + size());
+      write(records.data() + at);
+    }
+  };
+
+  template<typename Format, typename ... Arguments>
+  DeferredCall<Format, Arguments...> defer(const Format&, const Arguments& ... arguments) {
+    return { std::tie(arguments...) };
+  }
+
+  // The length of the next record, 0 if `available` bytes do not hold one
+  inline size_t deferred_length(const char* records, size_t available) {
+    if(available < internal::deferred_header_size)
+      return 0;
+    uint32_t length;
+    std::memcpy(&length, records, sizeof(length));
+    return length <= available ? length : 0;
+  }
+
+  /* Formats one record written by a program with the same registry and
+   * appends it to the output. Returns the length of the record, 0 if there
+   * is none or it can not be formatted.
+   */
+  inline size_t format_deferred(std::string& output, const char* records, size_t available) {
+    const size_t length = deferred_length(records, available);
+    if(!length)
+      return 0;
+    uint64_t id;
+    std::memcpy(&id, records + sizeof(uint32_t), sizeof(id));
+    const FormatRegistration* format = find_format(id);
+    if(!format || !format->decode)
+      return 0;
+    if(!format->decode(records + internal::deferred_header_size, output))
+      return 0;
+    return length;
+  }
+}
+
+#endif
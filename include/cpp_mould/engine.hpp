@@ -1,12 +1,15 @@
 #ifndef CPP_MOULD_ENGINE_HPP
 #define CPP_MOULD_ENGINE_HPP
 #include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <memory>
 #include <ostream>
 #include <span>
 
 #include "argument.hpp"
 #include "format_info.hpp"
+#include "simd.hpp"
 
 namespace mould::internal {
   // A character interface into some output. Do not worry, these virtual class
@@ -17,6 +20,7 @@ namespace mould::internal {
 
     virtual void append(const char* begin, const char* end) = 0;
     virtual void append(char) = 0;
+    virtual void fill(char, size_t count) = 0;
 
     virtual char* show_buf(size_t) = 0;
     virtual void put_buf(size_t) = 0;
@@ -38,6 +42,9 @@ namespace mould::internal {
     inline void append(char c) override {
       output.push_back(c);
     }
+    inline void fill(char c, size_t count) override {
+      output.append(count, c);
+    }
     inline char* show_buf(size_t) override {
       return nullptr;
     }
@@ -62,7 +69,7 @@ namespace mould::internal {
 
     inline void append(const char* begin, const char* end) override {
       const size_t len = end - begin;
-      if (len <= end - free) {
+      if (len <= static_cast<size_t>(this->end - free)) {
         switch (len) {
         case 2: *free++ = *begin++;
         case 1: *free++ = *begin++;
@@ -85,6 +92,19 @@ namespace mould::internal {
       *free++ = c;
     }
 
+    inline void fill(char c, size_t count) override {
+      while (count > 0) {
+        if (free == end) {
+          flush();
+        }
+
+        const size_t len = std::min<size_t>(count, end - free);
+        std::memset(free, c, len);
+        free += len;
+        count -= len;
+      }
+    }
+
     inline char* show_buf(size_t len) override {
       return len <= end - free ? free : nullptr;
     }
@@ -113,6 +133,127 @@ namespace mould::internal {
     const char* end;
   };
 
+  // Writes into a region that is known to be large enough, such as space
+  // reserved with show_buf for values of bounded width. Only checked in
+  // debug builds.
+  class SpanEngine: public Engine {
+  public:
+    SpanEngine(char* begin, char* end)
+      : begin(begin), free(begin), end(end)
+      { }
+
+    inline void append(const char* begin, const char* end) override {
+      assert(end - begin <= this->end - free);
+      std::memcpy(free, begin, end - begin);
+      free += end - begin;
+    }
+    inline void append(char c) override {
+      assert(free != end);
+      *free++ = c;
+    }
+    inline void fill(char c, size_t count) override {
+      assert(count <= static_cast<size_t>(end - free));
+      std::memset(free, c, count);
+      free += count;
+    }
+    inline char* show_buf(size_t len) override {
+      return len <= static_cast<size_t>(end - free) ? free : nullptr;
+    }
+    inline void put_buf(size_t len) override {
+      assert(len <= static_cast<size_t>(end - free));
+      free += len;
+    }
+
+    inline size_t written() const {
+      return free - begin;
+    }
+  private:
+    char* begin;
+    char* free;
+    char* end;
+  };
+
+  // Counts the output without keeping it, for sizing a buffer before the
+  // real formatting. Values formatted through show_buf go to a scratch area.
+  class CountingEngine: public Engine {
+  public:
+    inline void append(const char* begin, const char* end) override {
+      count += end - begin;
+    }
+    inline void append(char) override {
+      count++;
+    }
+    inline void fill(char, size_t count) override {
+      this->count += count;
+    }
+    inline char* show_buf(size_t len) override {
+      return len <= sizeof(scratch) ? scratch : nullptr;
+    }
+    inline void put_buf(size_t len) override {
+      count += len;
+    }
+
+    inline size_t counted() const {
+      return count;
+    }
+  private:
+    size_t count = 0;
+    char scratch[512];
+  };
+
+  // Writes a field of known width in place. Output past the field is
+  // dropped but counted, and show_buf beyond it is served from a scratch
+  // area that put_buf copies into the field.
+  class FieldEngine: public Engine {
+  public:
+    FieldEngine(char* begin, size_t width)
+      : free(begin), end(begin + width)
+      { }
+
+    inline void append(const char* begin, const char* end) override {
+      const size_t len = end - begin;
+      std::memcpy(free, begin, std::min(len, room()));
+      advance(len);
+    }
+    inline void append(char c) override {
+      if(room()) *free = c;
+      advance(1);
+    }
+    inline void fill(char c, size_t count) override {
+      std::memset(free, c, std::min(count, room()));
+      advance(count);
+    }
+    inline char* show_buf(size_t len) override {
+      shown = len <= room() ? free : len <= sizeof(scratch) ? scratch : nullptr;
+      return shown;
+    }
+    inline void put_buf(size_t len) override {
+      if(shown == scratch)
+        std::memcpy(free, scratch, std::min(len, room()));
+      advance(len);
+    }
+
+    // The full length of the output, the field holds all of it if this is
+    // not more than its width
+    inline size_t written() const {
+      return count;
+    }
+  private:
+    inline size_t room() const {
+      return end - free;
+    }
+    inline void advance(size_t len) {
+      free += std::min(len, room());
+      count += len;
+    }
+
+    char* free;
+    char* end;
+    char* shown = nullptr;
+    size_t count = 0;
+    char scratch[512];
+  };
+
   template<typename T>
   Immediate value_as_immediate(const T&);
 
@@ -128,12 +269,22 @@ namespace mould {
     engine.append(arg);
   }
 
-  inline void Formatter::append(std::string arg) const {
+  inline void Formatter::append(const std::string& arg) const {
     engine.append(arg.data(), arg.data() + arg.size());
   }
 
+  // The terminator is searched while copying into the engine buffer, so the
+  // string is read only once. Engines without a buffer get the length first.
   inline void Formatter::append(const char* arg) const {
-    engine.append(arg, arg + mould::internal::constexpr_str_len(arg));
+    constexpr size_t chunk = 256;
+    while(char* buffer = engine.show_buf(chunk)) {
+      const size_t length = internal::copy_c_string(buffer, arg, chunk);
+      engine.put_buf(length);
+      if(length < chunk)
+        return;
+      arg += chunk;
+    }
+    engine.append(arg, arg + internal::str_len(arg));
   }
 
   inline void Formatter::append(std::string_view sv) const {
@@ -147,6 +298,83 @@ namespace mould {
   inline void Formatter::put_buf(size_t req) {
     return engine.put_buf(req);
   }
+
+  inline size_t Formatter::padded_size(size_t length) const {
+    return std::max<size_t>(length, _format.width);
+  }
+
+  inline Formatter::Padding Formatter::padding_for(
+    size_t length, Alignment natural, size_t prefix) const
+  {
+    const size_t fill = _format.width - length;
+    Padding padding { 0, 0, 0, _format.has_padding ? (char) _format.padding : ' ' };
+
+    switch(_format.alignment) {
+    case Alignment::Left: padding.before = 0; break;
+    case Alignment::Right: padding.before = fill; break;
+    case Alignment::Center: padding.before = fill / 2; break;
+    case Alignment::Default:
+      if(natural != Alignment::Left) {
+        padding.before = fill;
+        padding.keep = _format.has_padding ? prefix : 0;
+      }
+      break;
+    }
+
+    padding.after = fill - padding.before;
+    return padding;
+  }
+
+  inline void Formatter::put_padded(char* buffer, size_t length, Alignment natural, size_t prefix) {
+    if(length >= _format.width) {
+      engine.put_buf(length);
+      return;
+    }
+
+    const auto padding = padding_for(length, natural, prefix);
+    char* const value = buffer + padding.keep;
+    std::memmove(value + padding.before, value, length - padding.keep);
+    std::memset(value, padding.fill, padding.before);
+    std::memset(buffer + padding.before + length, padding.fill, padding.after);
+    engine.put_buf(_format.width);
+  }
+
+  inline void Formatter::append_padded(std::string_view value, Alignment natural, size_t prefix) {
+    const size_t length = value.size();
+    if(length >= _format.width) {
+      engine.append(value.data(), value.data() + length);
+      return;
+    }
+
+    const auto padding = padding_for(length, natural, prefix);
+    if(char* buffer = engine.show_buf(_format.width)) {
+      std::memcpy(buffer, value.data(), padding.keep);
+      std::memset(buffer + padding.keep, padding.fill, padding.before);
+      std::memcpy(buffer + padding.keep + padding.before,
+        value.data() + padding.keep, length - padding.keep);
+      std::memset(buffer + padding.before + length, padding.fill, padding.after);
+      engine.put_buf(_format.width);
+    } else {
+      engine.append(value.data(), value.data() + padding.keep);
+      engine.fill(padding.fill, padding.before);
+      engine.append(value.data() + padding.keep, value.data() + length);
+      engine.fill(padding.fill, padding.after);
+    }
+  }
+
+  inline void Formatter::append_fill_before(size_t length, Alignment natural) {
+    if(length < _format.width) {
+      const auto padding = padding_for(length, natural, 0);
+      engine.fill(padding.fill, padding.before);
+    }
+  }
+
+  inline void Formatter::append_fill_after(size_t length, Alignment natural) {
+    if(length < _format.width) {
+      const auto padding = padding_for(length, natural, 0);
+      engine.fill(padding.fill, padding.after);
+    }
+  }
 }
 
 #endif
@@ -1,5 +1,6 @@
 #ifndef CPP_MOULD_FORMAT_HPP
 #define CPP_MOULD_FORMAT_HPP
+#include <string>
 #include <string_view>
 
 #include "bytecode.hpp"
@@ -22,6 +23,9 @@ namespace mould {
     
     Alignment alignment;
     Sign sign;
+    char grouping /* The separator of digit groups, 0 if none */;
+
+    std::string_view extension /* The spec text after '|' with its braces doubled, empty if none */;
   };
 
   struct FormatterInformation {
@@ -37,14 +41,39 @@ namespace mould {
   // implementation is found in "engine.hpp"
   class Formatter {
   public:
+    using Alignment = internal::Alignment;
+
     void append(char) const;
-    void append(std::string) const;
+    void append(const std::string&) const;
     void append(const char*) const;
     void append(std::string_view) const;
 
     char* show_buf(size_t req);
     void put_buf(size_t req);
 
+    // Padding of values according to width, alignment and fill of the
+    // format. `natural` is the alignment of the value type when the format
+    // does not choose one: `Right` for numbers, `Left` for text. Numbers keep
+    // their first `prefix` characters (sign, base prefix) in front of a fill
+    // that was given without explicit alignment, such as in `{:08}`.
+
+    // Space to request with show_buf for a value of at most `length` chars.
+    size_t padded_size(size_t length) const;
+    // Pads a value written to the start of a show_buf(padded_size(length))
+    // region in place and puts it.
+    void put_padded(char* buffer, size_t length, Alignment natural, size_t prefix = 0);
+    // Appends a value that has been formatted elsewhere with its padding.
+    void append_padded(std::string_view value, Alignment natural, size_t prefix = 0);
+    // The fill around a value of `length` chars that is appended in pieces.
+    void append_fill_before(size_t length, Alignment natural);
+    void append_fill_after(size_t length, Alignment natural);
+
+    // A formatter into the same output with another format, for the parts
+    // of a composite value.
+    inline Formatter with_format(const Format& format) const {
+      return Formatter{engine, format};
+    }
+
     inline const Format& format() const {
       return _format;
     }
@@ -53,6 +82,15 @@ namespace mould {
       : engine(engine), _format(format)
       { }
   private:
+    struct Padding {
+      size_t before /* fill characters in front of the value */;
+      size_t after /* fill characters after the value */;
+      size_t keep /* characters of the value kept in front of the fill */;
+      char fill;
+    };
+
+    Padding padding_for(size_t length, Alignment natural, size_t prefix) const;
+
     friend class internal::Engine;
     internal::Engine& engine;
     Format _format;
@@ -1,6 +1,8 @@
 #ifndef CPP_MOULD_FORMAT_INFO_HPP
 #define CPP_MOULD_FORMAT_INFO_HPP
 
+#include <type_traits>
+
 #include "format.hpp"
 
 namespace mould::internal {
@@ -19,8 +21,20 @@ namespace mould::internal {
   };
 
 
+  // The max_width of a ResultWithInformation, -1 if not known.
+  template<typename I, typename = void>
+  struct information_max_width {
+    constexpr static int value = -1;
+  };
+
+  template<typename I>
+  struct information_max_width<I, std::void_t<decltype(I::max_width)>> {
+    constexpr static int value = I::max_width;
+  };
+
   template<typename Fn>
   struct SingleValueFormatter {
+    constexpr static int max_width = -1;
     Fn function;
     constexpr auto get(FullOperation) const {
       return function;
@@ -29,6 +43,8 @@ namespace mould::internal {
 
   template<typename T, auto F, typename I>
   struct InformedFormatter {
+    constexpr static int max_width = information_max_width<I>::value;
+
     static FormattingResult proxy(const T& t, Formatter f) {
       return F(t, f);
     }
@@ -38,10 +54,25 @@ namespace mould::internal {
     }
   };
 
+  /* C::get(operation) picks a function specialized for the operation, or
+   * nullptr to use F. Without a known operation, as in the runtime driver,
+   * F is used. So is it for arguments only converted to the type of C.
+   */
   template<typename T, auto F, typename C>
   struct ChoosingFormatter {
-    constexpr auto get(FullOperation operation) const {
-      return C::get(operation);
+    using function = FormattingResult (*)(const T&, Formatter);
+    constexpr static int max_width = information_max_width<C>::value;
+
+    static FormattingResult proxy(const T& t, Formatter f) {
+      return F(t, f);
+    }
+
+    constexpr function get(FullOperation operation) const {
+      if constexpr(std::is_same_v<decltype(C::get(operation)), function>) {
+        if(const function chosen = C::get(operation))
+          return chosen;
+      }
+      return ChoosingFormatter::proxy;
     }
   };
 
@@ -65,6 +96,12 @@ namespace mould::internal {
     return InformedFormatter<T, F, I> { };
   }
 
+  // Dispatch for functions which choose by the exact format
+  template<auto F, typename T, typename C>
+  constexpr auto build_formatter(FineGrainedFormatChoice<C> (*fn)(const T&, Formatter)) {
+    return ChoosingFormatter<T, F, C> { };
+  }
+
   template<typename, typename Then>
   using Validate = Then;
 
@@ -115,8 +152,8 @@ CPP_MOULD_REPEAT_FOR_FORMAT_KINDS_MACRO(CPP_MOULD_DELAYED_FORMATTER)
   }
 
   template<typename T>
-  constexpr auto automatic_formatter(...) -> FormattingResult (*)(const T&, Formatter) {
-    return nullptr;
+  constexpr auto automatic_formatter(...) -> SingleValueFormatter<std::nullptr_t> {
+    return SingleValueFormatter<std::nullptr_t> { nullptr };
   }
 
   template<typename T>
@@ -144,11 +181,13 @@ CPP_MOULD_REPEAT_FOR_FORMAT_KINDS_MACRO(CPP_MOULD_DELAYED_FORMATTER)
   template<typename T>
   struct type_erase_function {
 #define CPP_MOULD_TYPE_ERASED_FORMAT(kind) \
+    constexpr static auto kind = TypedFormatter<T>:: kind.get(FullOperation{}); \
+ \
     static FormattingResult format_##kind(const void* self, Formatter formatter) { \
-      if constexpr(TypedFormatter<T>:: kind == nullptr) { \
+      if constexpr(kind == nullptr) { \
         return FormattingResult::Error; \
       } else { \
-        return TypedFormatter<T>:: kind(*reinterpret_cast<const T*>(self), formatter); \
+        return kind(*reinterpret_cast<const T*>(self), formatter); \
       } \
     }
 
@@ -173,7 +212,7 @@ CPP_MOULD_REPEAT_FOR_FORMAT_KINDS_MACRO(CPP_MOULD_DELAYED_FORMATTER)
 
       return TypeErasedFormatter {
         #define CPP_MOULD_TYPE_ERASED_FORMATTER_INIT(kind)\
-        type_erase_function<T>::format_##kind,
+        type_erase_function<T>:: kind == nullptr ? nullptr : type_erase_function<T>::format_##kind,
 
         CPP_MOULD_TYPE_ERASED_FORMATTER_INIT(automatic)
         CPP_MOULD_REPEAT_FOR_FORMAT_KINDS_MACRO(CPP_MOULD_TYPE_ERASED_FORMATTER_INIT)
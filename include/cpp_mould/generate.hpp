@@ -16,7 +16,7 @@ namespace mould::internal {
     EncodedOperation operation;
     bool noop;
 
-    Immediate _immediates[4];
+    Immediate _immediates[8];
     unsigned char used_immediates;
 
     constexpr BuiltOperation()
@@ -98,9 +98,41 @@ namespace mould::internal {
   }
 
   template<typename CharT>
-  constexpr void consume_index(Buffer<CharT>& inner, Formatting& target) {
+  constexpr bool is_letter(CharT chr) {
+    return (chr >= 'a' && chr <= 'z') || (chr >= 'A' && chr <= 'Z');
+  }
+
+  template<typename CharT>
+  constexpr bool is_name_character(CharT chr) {
+    return is_letter(chr) || chr == '_' || (chr >= '0' && chr <= '9');
+  }
+
+  /* A name starts with a letter and ends the field or precedes the ':'. A
+   * single letter alone, as in `{d}`, is the kind and not a name.
+   */
+  template<typename CharT>
+  constexpr bool consume_name(const Buffer<CharT>& full_input, Buffer<CharT>& inner, Formatting& target) {
+    if(inner.empty() || !is_letter(*inner.begin()))
+      return false;
+    Buffer<CharT> rest = inner;
+    while(!rest.empty() && is_name_character(*rest.begin()))
+      rest._begin++;
+    const size_t length = rest.begin() - inner.begin();
+    if(rest.empty() ? length < 2 : *rest.begin() != ':')
+      return false;
+    target.index = FormatArgument::Parameter;
+    target.name_offset = static_cast<Immediate>(inner.begin() - full_input.begin());
+    target.name_length = static_cast<Immediate>(length);
+    inner._begin = rest._begin;
+    return true;
+  }
+
+  // An index, or a name which the driver resolves to the argument given as
+  // `mould::arg<"name">(value)`
+  template<typename CharT>
+  constexpr void consume_index(const Buffer<CharT>& full_input, Buffer<CharT>& inner, Formatting& target) {
     unsigned index = 0;
-    if(consume_unsigned(inner, index)) {
+    if(!consume_name(full_input, inner, target) && consume_unsigned(inner, index)) {
       if(index < 0x100) {
         target.index = FormatArgument::Value;
         target.index_value = index;
@@ -110,19 +142,67 @@ namespace mould::internal {
       inner._begin++;
   }
 
+  template<typename CharT>
+  constexpr bool parse_align(CharT chr, Alignment& target) {
+    switch(chr) {
+    case '<': target = Alignment::Left; return true;
+    case '>': target = Alignment::Right; return true;
+    case '=': target = Alignment::Default; return true;
+    case '^': target = Alignment::Center; return true;
+    default:
+      return false;
+    }
+  }
+
+  // A nested field `{}` or `{N}` whose argument gives a value of the format.
+  // Without an index it takes the next argument, see FullOperationIterator.
+  template<typename CharT>
+  constexpr bool consume_parameter(Buffer<CharT>& inner, FormatArgument& kind, Immediate& value) {
+    if(inner.empty() || *inner.begin() != '{')
+      return false;
+    Buffer<CharT> nested = {inner._begin + 1, inner._end};
+    unsigned index = 0;
+    const bool indexed = consume_unsigned(nested, index);
+    if(indexed && index >= auto_parameter)
+      return false;
+    if(nested.empty() || *nested.begin() != '}')
+      return false;
+    kind = FormatArgument::Parameter;
+    value = indexed ? index : auto_parameter;
+    inner._begin = nested._begin + 1;
+    return true;
+  }
+
   template<typename CharT>
   constexpr void consume_align(Buffer<CharT>& inner, Formatting& target) {
     Alignment specified = Alignment::Default;
-    switch(*inner.begin()) {
-    case '<': specified = Alignment::Left; break;
-    case '>': specified = Alignment::Right; break;
-    case '=': specified = Alignment::Default; break;
-    case '^': specified = Alignment::Center; break;
-    default:
+
+    // A fill from an argument, `{}` followed by an alignment
+    Buffer<CharT> rest = inner;
+    Formatting fill = target;
+    if(consume_parameter(rest, fill.padding, fill.padding_value)
+        && !rest.empty() && parse_align(*rest.begin(), specified)) {
+      target.padding = fill.padding;
+      target.padding_value = fill.padding_value;
+      target.alignment = specified;
+      inner._begin = rest._begin + 1;
       return;
     }
-    target.alignment = specified;
-    inner._begin++;
+
+    // [[fill]align], the fill is any character followed by an alignment but
+    // '|', which starts the extension as in `{:|<|, |>}`
+    if(inner.length() >= 2 && *inner.begin() != '|' && parse_align(inner.begin()[1], specified)) {
+      target.padding = FormatArgument::Value;
+      target.padding_value = static_cast<Codepoint>(*inner.begin());
+      target.alignment = specified;
+      inner._begin += 2;
+      return;
+    }
+
+    if(!inner.empty() && parse_align(*inner.begin(), specified)) {
+      target.alignment = specified;
+      inner._begin++;
+    }
   }
 
   template<typename CharT>
@@ -146,17 +226,34 @@ namespace mould::internal {
       target.padding = FormatArgument::Value;
       target.padding_value = '0';
     }
+    if(inner.length() >= 2 && inner.begin()[0] == '0' && inner.begin()[1] == '{')
+      inner._begin++;
+    if(consume_parameter(inner, target.width, target.width_value))
+      return;
     if(!consume_unsigned(inner, specified))
       return;
     target.width = FormatArgument::Value;
     target.width_value = specified;
   }
 
+  template<typename CharT>
+  constexpr void consume_grouping(Buffer<CharT>& inner, Formatting& target) {
+    switch(*inner.begin()) {
+    case ',': target.grouping = Grouping::Comma; break;
+    case '_': target.grouping = Grouping::Underscore; break;
+    default:
+      return;
+    }
+    inner._begin++;
+  }
+
   template<typename CharT>
   constexpr void consume_precision(Buffer<CharT>& inner, Formatting& target) {
     if(*inner.begin() != '.')
       return;
     inner._begin++;
+    if(consume_parameter(inner, target.precision, target.precision_value))
+      return;
     unsigned specified = 0;
     if(!consume_unsigned(inner, specified))
       return;
@@ -170,22 +267,32 @@ namespace mould::internal {
 
     switch(*inner.begin()) {
     case 'b': specified = FormatKind::binary; break;
+    case 'B': specified = FormatKind::bytesize; break;
     case 'c': specified = FormatKind::character; break;
     case 'd': specified = FormatKind::decimal; break;
     case 'e': specified = FormatKind::exponent; break;
     case 'E': specified = FormatKind::EXPONENT; break;
     case 'f': specified = FormatKind::fpoint; break;
     case 'F': specified = FormatKind::FPOINT; break;
-    // case 'g': return FormatKind:: | "G" | "n" |
-    // Note: gGn are all similar to fpoint/decimal so I neglect them for now
-    // Also, they do not appear in C and all formats should not be affected
-    // by locale by design. Maybe this will get revisited later.
+    case 'g': specified = FormatKind::general; break;
+    case 'G': specified = FormatKind::GENERAL; break;
+    case 'h': specified = FormatKind::hexdump; break;
+    case 'j': specified = FormatKind::json; break;
+    case 'm': specified = FormatKind::base64; break;
+    // Note: n is similar to decimal/general but depends on the locale. All
+    // formats should not be affected by locale by design.
     case 'o': specified = FormatKind::octal; break;
     case 's': specified = FormatKind::string; break;
     case 'p': specified = FormatKind::pointer; break;
+    case 'q': specified = FormatKind::quoted; break;
+    case 't': specified = FormatKind::timespan; break;
     case 'x': specified = FormatKind::hex; break;
     case 'X': specified = FormatKind::HEX; break;
-    // | "%" // FIXME: support percentage
+    // Only a final '%', otherwise it starts a pattern such as `%H:%M`
+    case '%':
+      if(inner.length() != 1) return;
+      specified = FormatKind::percent;
+      break;
     default:
       return;
     }
@@ -194,6 +301,26 @@ namespace mould::internal {
     target.kind = specified;
   }
 
+  // Everything after a '|' is left to the formatter of the argument, such as
+  // the separator of a range. Braces in it are doubled, `{{` for '{' and `}}`
+  // for '}'. A pattern starting with '%', as in `{:%Y-%m-%d}`, is taken as a
+  // whole.
+  template<typename CharT>
+  constexpr void consume_extension(
+    const Buffer<CharT>& full_input,
+    Buffer<CharT>& inner,
+    Formatting& target)
+  {
+    if(inner.empty() || (*inner.begin() != '|' && *inner.begin() != '%'))
+      return;
+    if(*inner.begin() == '|')
+      inner._begin++;
+    target.extension = FormatArgument::Value;
+    target.extension_offset = static_cast<Immediate>(inner.begin() - full_input.begin());
+    target.extension_length = static_cast<Immediate>(inner.length());
+    inner._begin = inner._end;
+  }
+
   template<typename CharT>
   constexpr bool get_string_literal(
     CompilationInput<CharT>& input,
@@ -223,13 +350,33 @@ namespace mould::internal {
     auto& buffer = input.buffer;
     const auto begin = buffer.begin();
 
-    for(;; buffer._begin++) {
+    // Nested fields such as in `{:{}}` are part of the specifier. After the
+    // '|' of an extension braces are text, doubled, and a single '}' ends it.
+    bool extension = false;
+    for(unsigned depth = 0;; buffer._begin++) {
       if(buffer.empty()) {
         return false;
       }
-      if(*buffer.begin() == '}') {
+      const CharT next = *buffer.begin();
+      if(extension) {
+        if(next != '{' && next != '}')
+          continue;
+        if(buffer.length() >= 2 && buffer.begin()[1] == next) {
+          buffer._begin++;
+          continue;
+        }
+        if(next == '{')
+          return false;
+        buffer._begin++;
+        break;
+      }
+      if(next == '{') {
+        depth++;
+      } else if(next == '}' && --depth == 0) {
         buffer._begin++;
         break;
+      } else if(next == '|' && depth == 1) {
+        extension = true;
       }
     }
 
@@ -245,12 +392,14 @@ namespace mould::internal {
       builder.set_formatting(Formatting{});
 
     Buffer<CharT> inner_format = {format_buffer._begin + 1, format_buffer._end - 1};
-    consume_index(inner_format, builder.format);
+    consume_index(input.full_input, inner_format, builder.format);
     consume_align(inner_format, builder.format);
     consume_sign(inner_format, builder.format);
     consume_width(inner_format, builder.format);
+    consume_grouping(inner_format, builder.format);
     consume_precision(inner_format, builder.format);
     consume_kind(inner_format, builder.format);
+    consume_extension(input.full_input, inner_format, builder.format);
 
     format.buffer = format_buffer;
     format.operation = builder.Build();
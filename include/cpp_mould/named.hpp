@@ -0,0 +1,96 @@
+#ifndef CPP_MOULD_NAMED_HPP
+#define CPP_MOULD_NAMED_HPP
+/* Named arguments for fields such as `{name}` or `{name:>8}`. The name is
+ * part of the argument type, the constexpr driver resolves it to the
+ * position of the argument when the format is compiled.
+ */
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+namespace mould {
+  // The name of an argument as template parameter
+  template<size_t N>
+  struct FixedName {
+    char text[N];
+
+    constexpr FixedName(const char (&name)[N]) : text() {
+      for(size_t i = 0; i < N; i++)
+        text[i] = name[i];
+    }
+
+    constexpr std::string_view view() const {
+      return { text, N - 1 };
+    }
+  };
+
+  // A reference to the value, or the value itself for a copied argument
+  template<FixedName Name, typename T>
+  struct NamedArgument {
+    T value;
+  };
+
+  // The argument for the fields `{name}` of a format
+  template<FixedName Name, typename T>
+  constexpr NamedArgument<Name, const T&> arg(const T& value) {
+    return { value };
+  }
+}
+
+namespace mould::internal {
+  template<typename T>
+  constexpr const T& named_value(const T& argument) {
+    return argument;
+  }
+
+  template<FixedName Name, typename T>
+  constexpr const std::remove_reference_t<T>& named_value(const NamedArgument<Name, T>& argument) {
+    return argument.value;
+  }
+
+  template<typename T>
+  constexpr bool is_named_argument = false;
+
+  template<FixedName Name, typename T>
+  constexpr bool is_named_argument<NamedArgument<Name, T>> = true;
+
+  // The type that is formatted for an argument
+  template<typename T>
+  using named_type = std::remove_cvref_t<decltype(named_value(std::declval<const T&>()))>;
+
+  template<typename T>
+  constexpr std::string_view argument_name = {};
+
+  template<FixedName Name, typename T>
+  constexpr std::string_view argument_name<NamedArgument<Name, T>> = Name.view();
+
+  // The position of the argument with the name, the count if there is none
+  template<typename ... Arguments>
+  constexpr size_t named_index(std::string_view name) {
+    const std::array<std::string_view, sizeof...(Arguments)> names = {
+      argument_name<std::remove_cvref_t<Arguments>> ...
+    };
+    for(size_t index = 0; index < names.size(); index++) {
+      if(names[index] == name)
+        return index;
+    }
+    return sizeof...(Arguments);
+  }
+
+  // The position of a positional argument, which do not count the named
+  // arguments as in Python. The count if there is none.
+  template<typename ... Arguments>
+  constexpr size_t positional_index(size_t position) {
+    const std::array<bool, sizeof...(Arguments)> named = {
+      is_named_argument<std::remove_cvref_t<Arguments>> ...
+    };
+    for(size_t index = 0; index < named.size(); index++) {
+      if(!named[index] && position-- == 0)
+        return index;
+    }
+    return sizeof...(Arguments);
+  }
+}
+
+#endif
@@ -0,0 +1,348 @@
+#ifndef CPP_MOULD_REGISTRY_HPP
+#define CPP_MOULD_REGISTRY_HPP
+/* Registry of the formats used with known argument types. Each use of a
+ * format puts the address of its constant registration into the linker
+ * section `mould_formats`, identical registrations from several translation
+ * units are merged by the linker. Nothing runs at startup, the section can
+ * be read from the running program or from the binary with ELF tools.
+ *
+ * The id of a format is a hash of the format string and the argument type
+ * names, stable across builds with the same compiler. The formats can be
+ * written as a table that another process maps and searches by id, see
+ * `format_table` and test/formats.cpp.
+ */
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bytecode.hpp"
+
+#if defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+#define CPP_MOULD_HAS_REGISTRY 1
+#if UINTPTR_MAX == UINT64_MAX
+#define CPP_MOULD_REGISTRY_POINTER ".quad"
+#else
+#define CPP_MOULD_REGISTRY_POINTER ".long"
+#endif
+// The section attribute is not applied to template instantiations by all
+// compilers, the pointer is emitted by the assembler instead
+#define CPP_MOULD_REGISTER(entry) \
+  asm volatile(".pushsection mould_formats,\"aw\"\n\t.balign %c1\n\t" \
+    CPP_MOULD_REGISTRY_POINTER " %c0\n\t.popsection" :: "i"(entry), "i"(sizeof(void*)))
+#else
+#define CPP_MOULD_REGISTER(entry) static_cast<void>(entry)
+#endif
+
+namespace mould {
+  struct alignas(8) FormatRegistration {
+    uint64_t id;
+    const char* format;
+    uint32_t format_length;
+    uint32_t code_length;
+    const internal::Codepoint* code;
+    const internal::Immediate* immediates;
+    uint32_t immediate_length;
+    uint32_t signature_length;
+    // The argument type names, separated by ','
+    const char* signature;
+    // Appends a formatted deferred record, see "defer.hpp", nullptr if the
+    // arguments can not be deferred
+    bool (*decode)(const char* payload, std::string& output);
+
+    // The constant data of the format in the binary
+    constexpr size_t footprint() const {
+      return format_length + code_length*sizeof(internal::Codepoint)
+        + immediate_length*sizeof(internal::Immediate) + signature_length;
+    }
+  };
+}
+
+namespace mould::internal {
+  template<typename T>
+  constexpr std::string_view type_name() {
+    const std::string_view name = __PRETTY_FUNCTION__;
+    // [with T = int; ...] from GCC, [T = int] from Clang
+    const auto begin = name.find("T = ") + 4;
+    auto end = name.find(';', begin);
+    if(end == name.npos) end = name.rfind(']');
+    return name.substr(begin, end - begin);
+  }
+
+  template<typename ... Arguments>
+  struct ArgumentSignature {
+    constexpr static size_t length = (0 + ... + type_name<Arguments>().size())
+      + (sizeof...(Arguments) ? sizeof...(Arguments) - 1 : 0);
+
+    constexpr static auto text = [] {
+      std::array<char, length + 1> text = {};
+      size_t at = 0;
+      for(std::string_view name : { std::string_view{}, type_name<Arguments>() ... }) {
+        if(name.empty()) continue;
+        if(at) text[at++] = ',';
+        for(char chr : name) text[at++] = chr;
+      }
+      return text;
+    }();
+  };
+
+  constexpr uint64_t fnv1a(uint64_t hash, std::string_view text) {
+    for(char chr : text) {
+      hash ^= static_cast<unsigned char>(chr);
+      hash *= 0x100000001b3ull;
+    }
+    return hash;
+  }
+
+  // The format string without the terminating 0
+  template<typename Format>
+  constexpr std::string_view format_text() {
+    const auto& format = Format::data.format_string;
+    std::string_view text{format.begin(), static_cast<size_t>(format.length())};
+    if(!text.empty() && text.back() == '\0') text.remove_suffix(1);
+    return text;
+  }
+
+  template<typename Format, typename ... Arguments>
+  constexpr uint64_t format_id() {
+    const auto& signature = ArgumentSignature<Arguments...>::text;
+    return fnv1a(fnv1a(0xcbf29ce484222325ull, format_text<Format>()),
+      {signature.data(), signature.size()});
+  }
+
+  template<typename Format, typename ... Arguments>
+  constexpr FormatRegistration make_registration(
+    bool (*decode)(const char* payload, std::string& output))
+  {
+    using Signature = ArgumentSignature<Arguments...>;
+    return {
+      format_id<Format, Arguments...>(),
+      format_text<Format>().data(),
+      static_cast<uint32_t>(format_text<Format>().size()),
+      static_cast<uint32_t>(std::size(Format::data.code)),
+      Format::data.code,
+      Format::data.immediates,
+      static_cast<uint32_t>(std::size(Format::data.immediates)),
+      static_cast<uint32_t>(Signature::length),
+      Signature::text.data(),
+      decode,
+    };
+  }
+
+  // Hidden, such that its address is a link time constant also in shared
+  // libraries. Each library has its own registry.
+  template<typename Format, auto decode, typename ... Arguments>
+  struct Registered {
+    [[gnu::visibility("hidden")]] static const FormatRegistration entry;
+  };
+
+  template<typename Format, auto decode, typename ... Arguments>
+  constinit const FormatRegistration Registered<Format, decode, Arguments...>::entry
+    = make_registration<Format, Arguments...>(decode);
+
+  // Called by the drivers, adds the format to the registry section. Only
+  // `defer` registers a decoder, see "defer.hpp".
+  template<typename Format, typename ... Arguments>
+  inline void register_format() {
+    CPP_MOULD_REGISTER((&Registered<Format, nullptr, Arguments...>::entry));
+  }
+}
+
+#ifdef CPP_MOULD_HAS_REGISTRY
+// Defined by the linker for sections named as identifiers
+extern "C" const mould::FormatRegistration* __start_mould_formats[] [[gnu::weak]];
+extern "C" const mould::FormatRegistration* __stop_mould_formats[] [[gnu::weak]];
+#endif
+
+namespace mould::internal {
+  // The section as written by the linker, with one address per use
+  inline std::span<const FormatRegistration*> registry_section() {
+#ifdef CPP_MOULD_HAS_REGISTRY
+    if(__start_mould_formats && __stop_mould_formats)
+      return { __start_mould_formats, __stop_mould_formats };
+#endif
+    return {};
+  }
+}
+
+namespace mould {
+  /* All distinct formats of the program, sorted by id. The section is
+   * sorted in place on first use. Of a format registered with and without
+   * a decoder, the one with a decoder is kept. Empty where there is no
+   * registry.
+   */
+  inline std::span<const FormatRegistration* const> registered_formats() {
+    static const std::span<const FormatRegistration* const> formats = [] {
+      const auto section = internal::registry_section();
+      std::sort(section.begin(), section.end(), [](auto* left, auto* right) {
+        return left->id != right->id ? left->id < right->id : left->decode && !right->decode;
+      });
+      const auto same_id = [](auto* left, auto* right) { return left->id == right->id; };
+      const auto end = std::unique(section.begin(), section.end(), same_id);
+      return section.first(end - section.begin());
+    }();
+    return formats;
+  }
+
+  // The registration of an id, nullptr if there is none
+  inline const FormatRegistration* find_format(uint64_t id) {
+    const auto formats = registered_formats();
+    const auto found = std::lower_bound(formats.begin(), formats.end(), id,
+      [](auto* entry, uint64_t id) { return entry->id < id; });
+    return (found != formats.end() && (*found)->id == id) ? *found : nullptr;
+  }
+}
+
+namespace mould {
+  /* The formats in one block without pointers, for a file that another
+   * process maps: the header, the entries sorted by id, then the
+   * immediates, the bytecode and the text of all entries. Offsets are from
+   * the start of the table.
+   */
+  struct FormatTableHeader {
+    char magic[8];
+    uint32_t count;
+    uint32_t size;
+  };
+
+  struct FormatTableEntry {
+    uint64_t id;
+    uint32_t format_offset, format_length;
+    uint32_t code_offset, code_length;
+    uint32_t immediates_offset, immediate_length;
+    uint32_t signature_offset, signature_length;
+  };
+
+  namespace internal {
+    constexpr char format_table_magic[8] = {'m', 'o', 'u', 'l', 'd', 'f', 't', '1'};
+  }
+
+  // The registered formats of the program as table
+  inline std::string format_table() {
+    const auto formats = registered_formats();
+    const size_t entries_end = sizeof(FormatTableHeader) + formats.size()*sizeof(FormatTableEntry);
+    size_t size = entries_end;
+    for(const FormatRegistration* format : formats)
+      size += format->footprint();
+
+    std::string table(size, '\0');
+    FormatTableHeader header = { {}, static_cast<uint32_t>(formats.size()), static_cast<uint32_t>(size) };
+    std::memcpy(header.magic, internal::format_table_magic, sizeof(header.magic));
+    std::memcpy(table.data(), &header, sizeof(header));
+
+    // The immediates directly after the entries stay aligned
+    size_t at = entries_end;
+    const auto place = [&](const void* data, size_t length) {
+      if(length)
+        std::memcpy(table.data() + at, data, length);
+      at += length;
+      return static_cast<uint32_t>(at - length);
+    };
+    std::vector<FormatTableEntry> entries(formats.size());
+    for(size_t i = 0; i < formats.size(); i++) {
+      entries[i].id = formats[i]->id;
+      entries[i].immediate_length = formats[i]->immediate_length;
+      entries[i].immediates_offset = place(formats[i]->immediates,
+        formats[i]->immediate_length*sizeof(internal::Immediate));
+    }
+    for(size_t i = 0; i < formats.size(); i++) {
+      entries[i].code_length = formats[i]->code_length;
+      entries[i].code_offset = place(formats[i]->code, formats[i]->code_length*sizeof(internal::Codepoint));
+      entries[i].format_length = formats[i]->format_length;
+      entries[i].format_offset = place(formats[i]->format, formats[i]->format_length);
+      entries[i].signature_length = formats[i]->signature_length;
+      entries[i].signature_offset = place(formats[i]->signature, formats[i]->signature_length);
+    }
+    if(!entries.empty())
+      std::memcpy(table.data() + sizeof(FormatTableHeader), entries.data(), entries.size()*sizeof(FormatTableEntry));
+    return table;
+  }
+
+  /* A table written by `format_table`, such as a mapped file, searched by
+   * id without copying it. The bytes need the alignment of 8.
+   */
+  class FormatTable {
+  public:
+    // Empty if the bytes do not hold a table, or any entry points outside of
+    // it, has unaligned immediates or is not sorted by id
+    explicit FormatTable(std::span<const char> bytes) {
+      FormatTableHeader header;
+      if(bytes.size() < sizeof(header)
+          || reinterpret_cast<uintptr_t>(bytes.data()) % alignof(FormatTableEntry) != 0)
+        return;
+      std::memcpy(&header, bytes.data(), sizeof(header));
+      if(std::memcmp(header.magic, internal::format_table_magic, sizeof(header.magic)) != 0
+          || header.size > bytes.size() || header.size < sizeof(header)
+          || header.count > (header.size - sizeof(header))/sizeof(FormatTableEntry))
+        return;
+
+      const std::span<const FormatTableEntry> entries = {
+        reinterpret_cast<const FormatTableEntry*>(bytes.data() + sizeof(FormatTableHeader)), header.count };
+      for(size_t i = 0; i < entries.size(); i++) {
+        if(!valid_entry(entries[i], header.size) || (i && entries[i - 1].id >= entries[i].id))
+          return;
+      }
+      base = bytes.data();
+      table_entries = entries;
+    }
+
+    std::span<const FormatTableEntry> entries() const {
+      return table_entries;
+    }
+
+    // The entry of an id, nullptr if there is none
+    const FormatTableEntry* find(uint64_t id) const {
+      const auto found = std::lower_bound(table_entries.begin(), table_entries.end(), id,
+        [](const FormatTableEntry& entry, uint64_t id) { return entry.id < id; });
+      return (found != table_entries.end() && found->id == id) ? &*found : nullptr;
+    }
+
+    std::string_view format(const FormatTableEntry& entry) const {
+      return { base + entry.format_offset, entry.format_length };
+    }
+
+    std::string_view signature(const FormatTableEntry& entry) const {
+      return { base + entry.signature_offset, entry.signature_length };
+    }
+
+    std::span<const internal::Codepoint> code(const FormatTableEntry& entry) const {
+      return { reinterpret_cast<const internal::Codepoint*>(base + entry.code_offset), entry.code_length };
+    }
+
+    std::span<const internal::Immediate> immediates(const FormatTableEntry& entry) const {
+      return { reinterpret_cast<const internal::Immediate*>(base + entry.immediates_offset), entry.immediate_length };
+    }
+
+    // The constant data of all formats, as in FormatRegistration::footprint
+    size_t footprint() const {
+      size_t total = 0;
+      for(const FormatTableEntry& entry : table_entries) {
+        total += entry.format_length + entry.code_length*sizeof(internal::Codepoint)
+          + entry.immediate_length*sizeof(internal::Immediate) + entry.signature_length;
+      }
+      return total;
+    }
+
+  private:
+    // The data of the entry lies within the `size` bytes of the table
+    static bool valid_entry(const FormatTableEntry& entry, uint64_t size) {
+      const auto fits = [size](uint64_t offset, uint64_t length) {
+        return offset <= size && length <= size - offset;
+      };
+      return fits(entry.format_offset, entry.format_length)
+        && fits(entry.signature_offset, entry.signature_length)
+        && fits(entry.code_offset, uint64_t{entry.code_length}*sizeof(internal::Codepoint))
+        && fits(entry.immediates_offset, uint64_t{entry.immediate_length}*sizeof(internal::Immediate))
+        && entry.immediates_offset % alignof(internal::Immediate) == 0;
+    }
+
+    const char* base = nullptr;
+    std::span<const FormatTableEntry> table_entries;
+  };
+}
+
+#endif
@@ -0,0 +1,316 @@
+#ifndef CPP_MOULD_RING_HPP
+#define CPP_MOULD_RING_HPP
+/* A byte ring shared by many formatting threads and drained by one reader.
+ *
+ * A writer reserves a record with a single compare and swap on the head,
+ * formats into it in place and commits it with a release store of its used
+ * length. The reader writes all committed records from the tail in one
+ * batch, then zeroes them and releases the space. Records never wrap, the
+ * space left at the end of the ring is reserved as an empty record.
+ */
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "engine.hpp"
+#include "constexpr_driver.hpp"
+
+#if __has_include(<sys/uio.h>) && __has_include(<unistd.h>)
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#define CPP_MOULD_HAS_WRITEV 1
+#endif
+
+namespace mould::internal {
+  /* Precedes each record. `state` is 0 until the record is committed and
+   * then one more than its used length, `size` includes the header.
+   */
+  struct RingHeader {
+    uint32_t state;
+    uint32_t size;
+  };
+
+  constexpr size_t ring_alignment = sizeof(RingHeader);
+
+  constexpr size_t ring_record_size(size_t length) {
+    return (sizeof(RingHeader) + length + ring_alignment - 1) & ~(ring_alignment - 1);
+  }
+
+  struct RingSlot {
+    RingHeader* header;
+    char* begin;
+    size_t length;
+  };
+}
+
+namespace mould {
+  class Ring {
+  public:
+    /* `capacity` is rounded up to a power of two. Each formatting call
+     * reserves `reservation` bytes and an 8 byte header until the reader
+     * consumes it, whatever its length: with the default a line of 20 bytes
+     * takes 264 bytes of the ring. Longer output takes a slow path.
+     */
+    explicit Ring(size_t capacity, size_t reservation = 256)
+      : capacity(std::bit_ceil(std::max<size_t>(capacity, 4*internal::ring_record_size(reservation)))),
+        mask(this->capacity - 1),
+        reservation(reservation),
+        storage(new internal::RingHeader[this->capacity/sizeof(internal::RingHeader)]())
+      { }
+
+    // The longest record, such that a record fits even after a wrap
+    inline size_t max_record() const {
+      return capacity/2 - sizeof(internal::RingHeader);
+    }
+
+    inline size_t default_reservation() const {
+      return reservation;
+    }
+
+    /* Reserves space for at least `length` <= max_record() bytes. Waits
+     * while the reader has not released enough space.
+     */
+    inline internal::RingSlot reserve(size_t length) {
+      const size_t size = internal::ring_record_size(length);
+      uint64_t at = head.load(std::memory_order_relaxed);
+      size_t skip;
+      for(;;) {
+        const size_t offset = at & mask;
+        skip = offset + size > capacity ? capacity - offset : 0;
+        if(at + skip + size - tail.load(std::memory_order_acquire) > capacity) {
+          std::this_thread::yield();
+          at = head.load(std::memory_order_relaxed);
+          continue;
+        }
+        if(head.compare_exchange_weak(at, at + skip + size, std::memory_order_relaxed))
+          break;
+      }
+
+      if(skip) {
+        internal::RingHeader* empty = header_at(at);
+        empty->size = static_cast<uint32_t>(skip);
+        std::atomic_ref<uint32_t>{empty->state}.store(1, std::memory_order_release);
+      }
+
+      internal::RingHeader* header = header_at(at + skip);
+      header->size = static_cast<uint32_t>(size);
+      return { header, reinterpret_cast<char*>(header + 1), size - sizeof(internal::RingHeader) };
+    }
+
+    // Publishes the first `used` bytes of a reserved slot to the reader
+    inline void commit(const internal::RingSlot& slot, size_t used) {
+      std::atomic_ref<uint32_t>{slot.header->state}.store(
+        static_cast<uint32_t>(used + 1), std::memory_order_release);
+    }
+
+    /* Only for the reader thread. Calls `sink(records, count)` once with the
+     * committed records in order, as an array of string_view, and then
+     * releases them. Returns the number of bytes passed to the sink.
+     */
+    template<typename Sink>
+    size_t consume(Sink&& sink) {
+      constexpr size_t batch = 256;
+      std::string_view records[batch];
+      size_t count = 0, bytes = 0;
+
+      const uint64_t start = tail.load(std::memory_order_relaxed);
+      uint64_t at = start;
+      while(count < batch && at - start < capacity) {
+        internal::RingHeader* header = header_at(at);
+        const uint32_t state = std::atomic_ref<uint32_t>{header->state}.load(std::memory_order_acquire);
+        if(!state)
+          break;
+        if(state > 1) {
+          records[count++] = { reinterpret_cast<const char*>(header + 1), state - size_t{1} };
+          bytes += state - 1;
+        }
+        at += header->size;
+      }
+
+      if(at == start)
+        return 0;
+      if(count)
+        sink(static_cast<const std::string_view*>(records), count);
+
+      // Writers expect zeroed headers wherever their record starts
+      const size_t from = start & mask, to = at & mask;
+      char* const base = reinterpret_cast<char*>(storage.get());
+      if(from < to) {
+        std::memset(base + from, 0, to - from);
+      } else {
+        std::memset(base + from, 0, capacity - from);
+        std::memset(base, 0, to);
+      }
+      tail.store(at, std::memory_order_release);
+      return bytes;
+    }
+
+#ifdef CPP_MOULD_HAS_WRITEV
+    /* Only for the reader thread. Writes the committed records to a file
+     * descriptor with writev. Records that can not be written are dropped,
+     * writers never wait on a failing output.
+     */
+    inline size_t drain(int fd) {
+      return consume([fd](const std::string_view* records, size_t count) {
+        iovec vectors[256];
+        for(size_t i = 0; i < count; i++)
+          vectors[i] = { const_cast<char*>(records[i].data()), records[i].size() };
+
+        iovec* next = vectors;
+        size_t left = count;
+        while(left) {
+          const ssize_t written = ::writev(fd, next, static_cast<int>(std::min<size_t>(left, IOV_MAX)));
+          if(written < 0) {
+            if(errno == EINTR) continue;
+            return;
+          }
+          // Skip the fully written vectors, then advance into a partial one
+          size_t done = written;
+          while(left && done >= next->iov_len) {
+            done -= next->iov_len;
+            next++, left--;
+          }
+          if(left) {
+            next->iov_base = static_cast<char*>(next->iov_base) + done;
+            next->iov_len -= done;
+          }
+        }
+      });
+    }
+#endif
+
+  private:
+    inline internal::RingHeader* header_at(uint64_t position) {
+      return storage.get() + (position & mask)/sizeof(internal::RingHeader);
+    }
+
+    const size_t capacity;
+    const size_t mask;
+    const size_t reservation;
+    std::unique_ptr<internal::RingHeader[]> storage;
+
+    // Written by the writers and the reader respectively
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+  };
+}
+
+namespace mould::internal {
+  /* Formats in place into one reservation of the ring. Output that does not
+   * fit is continued in a string and committed as a record of exact size.
+   * Up to max_record() bytes a call is published at once, longer output is
+   * split into several records between which other writers can publish.
+   */
+  class RingEngine: public Engine {
+  public:
+    RingEngine(Ring& ring)
+      : ring(ring), slot(ring.reserve(ring.default_reservation())),
+        free(slot.begin), end(slot.begin + slot.length)
+      { }
+
+    ~RingEngine() {
+      commit();
+    }
+
+    inline void append(const char* begin, const char* end) override {
+      const size_t len = end - begin;
+      if(len <= static_cast<size_t>(this->end - free)) {
+        std::memcpy(free, begin, len);
+        free += len;
+      } else {
+        spill().append(begin, len);
+      }
+    }
+
+    inline void append(char c) override {
+      if(free != end) {
+        *free++ = c;
+      } else {
+        spill().push_back(c);
+      }
+    }
+
+    inline void fill(char c, size_t count) override {
+      if(count <= static_cast<size_t>(end - free)) {
+        std::memset(free, c, count);
+        free += count;
+      } else {
+        spill().append(count, c);
+      }
+    }
+
+    inline char* show_buf(size_t len) override {
+      return len <= static_cast<size_t>(end - free) ? free : nullptr;
+    }
+
+    inline void put_buf(size_t len) override {
+      free += len;
+    }
+
+    inline void commit() {
+      if(!slot.header)
+        return;
+
+      if(!spilled) {
+        ring.commit(slot, free - slot.begin);
+      } else {
+        // The slow path, the reservation is published empty
+        ring.commit(slot, 0);
+        std::string_view rest = overflow;
+        while(!rest.empty()) {
+          // Only output longer than max_record() is split into records
+          const size_t length = std::min(rest.size(), ring.max_record());
+          const RingSlot exact = ring.reserve(length);
+          std::memcpy(exact.begin, rest.data(), length);
+          ring.commit(exact, length);
+          rest.remove_prefix(length);
+        }
+      }
+      slot.header = nullptr;
+    }
+
+  private:
+    // Moves the output so far into the overflow string, which then takes
+    // all further output
+    inline std::string& spill() {
+      if(!spilled) {
+        spilled = true;
+        overflow.assign(slot.begin, free);
+        free = end;
+      }
+      return overflow;
+    }
+
+    Ring& ring;
+    RingSlot slot;
+    char* free;
+    char* end;
+    bool spilled = false;
+    std::string overflow;
+  };
+}
+
+namespace mould {
+  // Formats into the ring from any thread, see `Ring::drain` for the reader
+  template<typename Format, typename ... Arguments>
+  void write_ring(
+    Format& format_string,
+    Ring& output,
+    Arguments&&... arguments)
+  {
+    using namespace internal::constexpr_driver;
+
+    internal::RingEngine engine{output};
+    eval<Format>(engine, arguments...);
+  }
+}
+
+#endif
@@ -1,9 +1,12 @@
 #ifndef CPP_MOULD_RUNTIME_DRIVER_HPP
 #define CPP_MOULD_RUNTIME_DRIVER_HPP
+#include <type_traits>
+
 #include "debug.hpp"
 #include "format.hpp"
 #include "format_info.hpp"
 #include "engine.hpp"
+#include "named.hpp"
 
 
 namespace mould::internal {
@@ -37,6 +40,15 @@ namespace mould::internal {
 
     DriverResult execute();
   private:
+    // The value of a format field, from an argument for a Parameter
+    bool value_of(FormatArgument kind, Immediate& value) const;
+
+    // The argument of an insert, nullptr if there is none
+    const TypeErasedArgument* argument_of(const Formatting& formatting) const;
+
+    // Positional arguments skip the named ones, nullptr if there is none
+    const TypeErasedArgument* positional(size_t position) const;
+
     StringEngine engine;
     const Buffer<const char> format_buffer;
     FullOperationIterator iterator;
@@ -47,14 +59,20 @@ namespace mould::internal {
   struct TypeErasedArgument {
     template<typename T>
     TypeErasedArgument(const T& value)
-      : formatter(TypeErasedFormatter::Construct<T>()),
-        argument((const void*) std::addressof(value)),
-        as_value(value_as_immediate(value))
+      : formatter(TypeErasedFormatter::Construct<named_type<T>>()),
+        argument((const void*) std::addressof(named_value(value))),
+        as_value(value_as_immediate(named_value(value))),
+        integral(std::is_integral_v<named_type<T>>),
+        name(argument_name<T>)
       { }
 
     TypeErasedFormatter formatter;
     const void*         argument;
     const Immediate     as_value;
+    // Only integers and characters are values of a format
+    const bool          integral;
+    // Empty unless given as `mould::arg<"name">(value)`
+    std::string_view    name;
 
     type_erased_formatting_function formatter_for(FormatKind kind) const {
       return formatter.formatter_for(kind);
@@ -88,7 +106,7 @@ namespace mould {
 }
 
 namespace mould::internal {
-  DriverResult RuntimeDriver::execute() {
+  inline DriverResult RuntimeDriver::execute() {
 
     while(!iterator.code_buffer.empty()) {
       auto latest = *iterator;
@@ -101,8 +119,22 @@ namespace mould::internal {
       case OpCode::Insert: {
           auto& formatting = latest.formatting;
 
-          auto& argument = args_begin[formatting.index_value];
-          auto formatting_fn = argument.formatter_for(formatting.kind);
+          if(!value_of(formatting.width, formatting.width_value)
+            || !value_of(formatting.precision, formatting.precision_value)
+            || !value_of(formatting.padding, formatting.padding_value))
+            return DriverResult {
+              DriverResultType::FormattingError,
+              formatting.kind
+            };
+
+          const TypeErasedArgument* argument = argument_of(formatting);
+          if(!argument)
+            return DriverResult {
+              DriverResultType::FormattingError,
+              formatting.kind
+            };
+
+          auto formatting_fn = argument->formatter_for(formatting.kind);
 
           if(!formatting_fn)
             return DriverResult {
@@ -115,16 +147,21 @@ namespace mould::internal {
             formatting.precision_value,
             formatting.padding_value,
 
-            formatting.width == FormatArgument::Auto,
-            formatting.precision == FormatArgument::Auto,
-            formatting.padding == FormatArgument::Auto,
+            formatting.width != FormatArgument::Auto,
+            formatting.precision != FormatArgument::Auto,
+            formatting.padding != FormatArgument::Auto,
             
             formatting.alignment,
-            formatting.sign
+            formatting.sign,
+            grouping_separator(formatting.grouping),
+
+            std::string_view{
+              format_buffer.begin() + formatting.extension_offset,
+              formatting.extension_length}
           };
 
           Formatter formatter {engine, format};
-          auto result = formatting_fn(argument.argument, formatter);
+          auto result = formatting_fn(argument->argument, formatter);
           if(result == FormattingResult::Error)
             return DriverResult {
               DriverResultType::FormattingError,
@@ -140,10 +177,45 @@ namespace mould::internal {
     };
   }
 
+  inline bool RuntimeDriver::value_of(FormatArgument kind, Immediate& value) const {
+    if(kind != FormatArgument::Parameter)
+      return true;
+    const TypeErasedArgument* argument = positional(value);
+    if(!argument || !argument->integral)
+      return false;
+    value = argument->as_value;
+    return true;
+  }
+
+  inline const TypeErasedArgument* RuntimeDriver::argument_of(const Formatting& formatting) const {
+    if(formatting.index != FormatArgument::Parameter)
+      return positional(formatting.index_value);
+    // Without argument types the name is only known now
+    const std::string_view name{format_buffer.begin() + formatting.name_offset, formatting.name_length};
+    for(const TypeErasedArgument* argument = args_begin; argument != args_end; argument++) {
+      if(argument->name == name)
+        return argument;
+    }
+    return nullptr;
+  }
+
+  inline const TypeErasedArgument* RuntimeDriver::positional(size_t position) const {
+    for(const TypeErasedArgument* argument = args_begin; argument != args_end; argument++) {
+      if(argument->name.empty() && position-- == 0)
+        return argument;
+    }
+    return nullptr;
+  }
+
+  // Negative widths and precisions count as 0, characters keep their code
   template<typename T>
   Immediate value_as_immediate(const T& val) {
     if constexpr(!std::is_constructible<Immediate, const T&>::value) {
       return static_cast<Immediate>(-1);
+    } else if constexpr(std::is_same_v<T, char>) {
+      return static_cast<unsigned char>(val);
+    } else if constexpr(std::is_signed_v<T>) {
+      return val < 0 ? 0 : static_cast<Immediate>(val);
     } else {
       return static_cast<Immediate>(val);
     }
@@ -0,0 +1,181 @@
+#ifndef CPP_MOULD_SIMD_HPP
+#define CPP_MOULD_SIMD_HPP
+/* Vector helpers for scanning and copying bytes. Only the instruction sets
+ * enabled for the compilation are used (-msse2 is the x86-64 default, AVX2
+ * with -mavx2), everything else falls back to scalar code.
+ */
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CPP_MOULD_SIMD_BLOCK 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CPP_MOULD_SIMD_BLOCK 16
+#endif
+
+// Vector loads may touch bytes around the string that are in the same page
+// but outside the object, which is safe but not what ASan expects.
+#if defined(__clang__) || defined(__GNUC__)
+#define CPP_MOULD_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+#define CPP_MOULD_NO_SANITIZE_ADDRESS
+#endif
+
+namespace mould::internal::simd {
+  // Memory protection works on whole pages, a load that stays inside the page
+  // of a valid byte never faults.
+  constexpr size_t page_size = 4096;
+
+  inline bool crosses_page(const void* at, size_t length) {
+    return (reinterpret_cast<uintptr_t>(at) & (page_size - 1)) > page_size - length;
+  }
+
+  inline unsigned trailing_zeros(uint32_t mask) {
+    return static_cast<unsigned>(std::countr_zero(mask));
+  }
+
+#if CPP_MOULD_SIMD_BLOCK == 32
+  struct Block {
+    static constexpr size_t size = 32;
+    __m256i value;
+
+    CPP_MOULD_NO_SANITIZE_ADDRESS
+    static Block load(const char* at) {
+      return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(at)) };
+    }
+
+    CPP_MOULD_NO_SANITIZE_ADDRESS
+    static Block load_aligned(const char* at) {
+      return { _mm256_load_si256(reinterpret_cast<const __m256i*>(at)) };
+    }
+
+    void store(char* at) const {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(at), value);
+    }
+
+    // One bit per byte equal to `chr`
+    uint32_t equal(char chr) const {
+      return static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(value, _mm256_set1_epi8(chr))));
+    }
+
+    // One bit per byte that is, as unsigned value, at most `bound`
+    uint32_t at_most(unsigned char bound) const {
+      const auto limit = _mm256_set1_epi8(static_cast<char>(bound));
+      return static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_min_epu8(value, limit), value)));
+    }
+
+    // One bit per byte that is, as unsigned value, at least `bound`
+    uint32_t at_least(unsigned char bound) const {
+      const auto limit = _mm256_set1_epi8(static_cast<char>(bound));
+      return static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_max_epu8(value, limit), value)));
+    }
+  };
+#elif CPP_MOULD_SIMD_BLOCK == 16
+  struct Block {
+    static constexpr size_t size = 16;
+    __m128i value;
+
+    CPP_MOULD_NO_SANITIZE_ADDRESS
+    static Block load(const char* at) {
+      return { _mm_loadu_si128(reinterpret_cast<const __m128i*>(at)) };
+    }
+
+    CPP_MOULD_NO_SANITIZE_ADDRESS
+    static Block load_aligned(const char* at) {
+      return { _mm_load_si128(reinterpret_cast<const __m128i*>(at)) };
+    }
+
+    void store(char* at) const {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(at), value);
+    }
+
+    // One bit per byte equal to `chr`
+    uint32_t equal(char chr) const {
+      return static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_cmpeq_epi8(value, _mm_set1_epi8(chr))));
+    }
+
+    // One bit per byte that is, as unsigned value, at most `bound`
+    uint32_t at_most(unsigned char bound) const {
+      const auto limit = _mm_set1_epi8(static_cast<char>(bound));
+      return static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_min_epu8(value, limit), value)));
+    }
+
+    // One bit per byte that is, as unsigned value, at least `bound`
+    uint32_t at_least(unsigned char bound) const {
+      const auto limit = _mm_set1_epi8(static_cast<char>(bound));
+      return static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_max_epu8(value, limit), value)));
+    }
+  };
+#endif
+}
+
+namespace mould::internal {
+  // The length of a nul terminated string. Aligned blocks never cross a page
+  // boundary, so the first one may safely start before the string.
+  CPP_MOULD_NO_SANITIZE_ADDRESS
+  inline size_t str_len(const char* str) {
+#ifdef CPP_MOULD_SIMD_BLOCK
+    using simd::Block;
+    const auto misalign = reinterpret_cast<uintptr_t>(str) & (Block::size - 1);
+    const char* block = str - misalign;
+
+    uint32_t mask = Block::load_aligned(block).equal(0) >> misalign;
+    if(mask)
+      return simd::trailing_zeros(mask);
+
+    for(;;) {
+      block += Block::size;
+      mask = Block::load_aligned(block).equal(0);
+      if(mask)
+        return static_cast<size_t>(block - str) + simd::trailing_zeros(mask);
+    }
+#else
+    return std::strlen(str);
+#endif
+  }
+
+  // Copies the nul terminated `src` into `dst` while searching its end, at
+  // most `capacity` characters. Returns the length of the string or
+  // `capacity` if it is longer. Whole blocks are copied, the bytes of `dst`
+  // after the string up to `capacity` are clobbered.
+  CPP_MOULD_NO_SANITIZE_ADDRESS
+  inline size_t copy_c_string(char* dst, const char* src, size_t capacity) {
+    size_t copied = 0;
+#ifdef CPP_MOULD_SIMD_BLOCK
+    using simd::Block;
+    while(copied + Block::size <= capacity) {
+      if(simd::crosses_page(src + copied, Block::size)) {
+        // Single bytes up to the page boundary, then blocks again
+        const auto offset = reinterpret_cast<uintptr_t>(src + copied) & (simd::page_size - 1);
+        for(const size_t boundary = copied + simd::page_size - offset; copied < boundary; copied++) {
+          if(!(dst[copied] = src[copied]))
+            return copied;
+        }
+        continue;
+      }
+      const auto block = Block::load(src + copied);
+      block.store(dst + copied);
+      if(const auto mask = block.equal(0))
+        return copied + simd::trailing_zeros(mask);
+      copied += Block::size;
+    }
+#endif
+    for(; copied < capacity; copied++) {
+      if(!(dst[copied] = src[copied]))
+        return copied;
+    }
+    return capacity;
+  }
+}
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef CPP_MOULD_STAMP_HPP
+#define CPP_MOULD_STAMP_HPP
+/* Lines of a format whose fields all have a fixed width, such as
+ * `{:08d} {:>10}`. The position of every field is known from the bytecode,
+ * so the literals are written once and each new line only overwrites the
+ * bytes of its fields. Useful for many lines of the same shape and for a
+ * status line that is updated in place.
+ */
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "engine.hpp"
+#include "constexpr_driver.hpp"
+
+namespace mould::internal {
+  template<size_t N>
+  struct StampLayout {
+    size_t offset[N] /* of each expression in the line */;
+    size_t width[N];
+    size_t source[N] /* of each literal in the format string */;
+    size_t size;
+    bool fixed /* every field has a width value */;
+  };
+
+  template<typename Format>
+  constexpr auto _stamp_layout() -> StampLayout<std::size(Format::data.code)> {
+    StampLayout<std::size(Format::data.code)> layout = {{}, {}, {}, 0, true};
+    FullOperationIterator iterator{Format::data.code, Format::data.immediates};
+
+    for(size_t index = 0; !iterator.code_buffer.empty(); index++) {
+      const auto op = *iterator;
+      layout.offset[index] = layout.size;
+      if(op.operation.operation.type == OpCode::Insert) {
+        if(op.formatting.width != FormatArgument::Value)
+          layout.fixed = false;
+        layout.width[index] = op.formatting.width_value;
+      } else {
+        layout.width[index] = op.literal.length;
+        layout.source[index] = op.literal.offset;
+      }
+      layout.size += layout.width[index];
+    }
+
+    return layout;
+  }
+
+  template<typename Format>
+  constexpr auto stamp_layout = _stamp_layout<Format>();
+}
+
+namespace mould {
+  template<typename Format>
+  class Stamp {
+    constexpr static auto& layout = internal::stamp_layout<Format>;
+    static_assert(layout.fixed, "Every field of a stamped format needs a fixed width");
+
+  public:
+    // The length of every line
+    constexpr static size_t size = layout.size;
+
+    Stamp(Format&) : line(skeleton()) { }
+
+    // The literals of the format with blank fields
+    static std::string skeleton() {
+      std::string line(size, ' ');
+      const char* const format = Format::data.format_buffer().begin();
+      for(size_t index = 0; index < std::size(Format::data.code); index++) {
+        if(internal::constexpr_driver::ExpressionData<Format>.indices[index] < 0)
+          std::copy_n(format + layout.source[index], layout.width[index], line.data() + layout.offset[index]);
+      }
+      return line;
+    }
+
+    /* Overwrites the fields of a line that starts with the skeleton. Returns
+     * false if a value is longer than its field, the field then holds the
+     * start of the value.
+     */
+    template<typename ... Arguments>
+    static bool fill(char* line, const Arguments& ... arguments) {
+      internal::register_format<Format, Arguments...>();
+      return fill_fields(line, std::make_index_sequence<std::size(Format::data.code)>{}, arguments...);
+    }
+
+    // The line of this stamp
+    template<typename ... Arguments>
+    bool update(const Arguments& ... arguments) {
+      return fill(line.data(), arguments...);
+    }
+
+    std::string_view text() const {
+      return line;
+    }
+
+  private:
+    template<size_t ... Indices, typename ... Arguments>
+    static bool fill_fields(char* line, std::index_sequence<Indices...>, const Arguments& ... arguments) {
+      using namespace internal::constexpr_driver;
+      using Compiled = decltype(CompiledExpressions<Format, Arguments...>);
+      const auto field = [&](auto index) {
+        if constexpr(ExpressionData<Format, Arguments...>.indices[index] < 0) {
+          return true;
+        } else {
+          internal::FieldEngine engine{line + layout.offset[index], layout.width[index]};
+          const ExpressionContext<internal::FieldEngine> context{engine, Format::data.format_buffer()};
+          Eval<internal::FieldEngine, typename Compiled::template ExpressionType<index>>
+            ::template evaluate<Format, index>(context, arguments...);
+          // A value shorter than its field replaces all of the previous one
+          const size_t written = engine.written();
+          if(written < layout.width[index])
+            std::fill_n(line + layout.offset[index] + written, layout.width[index] - written, ' ');
+          return written <= layout.width[index];
+        }
+      };
+      return (field(std::integral_constant<size_t, Indices>{}) & ...);
+    }
+
+    std::string line;
+  };
+}
+
+#endif
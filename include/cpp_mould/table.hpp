@@ -0,0 +1,104 @@
+#ifndef CPP_MOULD_TABLE_HPP
+#define CPP_MOULD_TABLE_HPP
+/* Aligned tables from a row format. A counting pass measures the widest
+ * value of every field over all rows, then the rows are formatted again
+ * with that width in place of the width of the field. No text of a cell is
+ * kept between the passes.
+ */
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "engine.hpp"
+#include "constexpr_driver.hpp"
+
+namespace mould::internal {
+  template<typename Format, typename Row>
+  struct TableFormat;
+
+  template<typename Format, typename ... Arguments>
+  struct TableFormat<Format, std::tuple<Arguments...>> {
+    constexpr static size_t count = std::size(Format::data.code);
+    using Compiled = decltype(constexpr_driver::CompiledExpressions<Format, Arguments...>);
+    using Widths = std::array<size_t, count>;
+
+    template<size_t index>
+    constexpr static bool is_field = constexpr_driver::ExpressionData<Format, Arguments...>.indices[index] >= 0;
+
+    // The widest value of each field, the literal lengths of a row
+    template<size_t ... Indices>
+    static void measure(Widths& widths, std::index_sequence<Indices...>, const Arguments& ... arguments) {
+      using namespace constexpr_driver;
+      const auto width = [&](auto index) {
+        CountingEngine engine;
+        const ExpressionContext<CountingEngine> context{engine, Format::data.format_buffer()};
+        Eval<CountingEngine, typename Compiled::template ExpressionType<index>>
+          ::template evaluate<Format, index>(context, arguments...);
+        widths[index] = std::max(widths[index], engine.counted());
+      };
+      (width(std::integral_constant<size_t, Indices>{}), ...);
+    }
+
+    template<typename EngineImpl, size_t ... Indices>
+    static void write(EngineImpl& engine, const Widths& widths, std::index_sequence<Indices...>, const Arguments& ... arguments) {
+      using namespace constexpr_driver;
+      const ExpressionContext<EngineImpl> context{engine, Format::data.format_buffer()};
+      const auto cell = [&](auto index) {
+        using Expression = typename Compiled::template ExpressionType<index>;
+        if constexpr(is_field<index>) {
+          auto format = expression_format<Format, index>(context.format_buffer, arguments...);
+          format.width = widths[index];
+          format.has_width = true;
+          Eval<EngineImpl, Expression>::template evaluate_with<Format, index>(context, format, arguments...);
+        } else {
+          Eval<EngineImpl, Expression>::template evaluate<Format, index>(context, arguments...);
+        }
+      };
+      (cell(std::integral_constant<size_t, Indices>{}), ...);
+    }
+  };
+}
+
+namespace mould {
+  /* Appends `rows`, a contiguous range of tuples of the arguments, with the
+   * fields of the format aligned in columns. A width in the format is the
+   * least width of its column, the alignment and fill are kept.
+   */
+  template<typename Format, typename Rows>
+  void format_table(
+    Format& format_string,
+    const Rows& rows,
+    std::string& output)
+  {
+    using Row = std::remove_cv_t<std::remove_reference_t<decltype(*std::data(rows))>>;
+    using Table = internal::TableFormat<Format, Row>;
+    constexpr auto indices = std::make_index_sequence<Table::count>{};
+
+    const auto* data = std::data(rows);
+    const size_t count = std::size(rows);
+    if(!count)
+      return;
+
+    typename Table::Widths widths{};
+    for(size_t row = 0; row < count; row++)
+      std::apply([&](const auto& ... arguments) { Table::measure(widths, indices, arguments...); }, data[row]);
+
+    // Every cell is now exactly as wide as its column
+    size_t line = 0;
+    for(size_t width : widths)
+      line += width;
+
+    const size_t at = output.size();
+    output.resize(at + line*count);
+    internal::SpanEngine engine{output.data() + at, output.data() + at + line*count};
+    for(size_t row = 0; row < count; row++)
+      std::apply([&](const auto& ... arguments) { Table::write(engine, widths, indices, arguments...); }, data[row]);
+    output.resize(at + engine.written());
+  }
+}
+
+#endif
@@ -0,0 +1,55 @@
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <sstream>
+#include <string>
+
+#include "check.hpp"
+
+static constexpr char bytes[] = "{:x}|";
+static constexpr char line[] = "{} {:>4} {}|";
+static constexpr char named[] = "{name}={value}|";
+
+int main() {
+  std::ostringstream output;
+  {
+    mould::AsyncPool pool{2};
+    mould::AsyncSink* sink = pool.add_sink(output);
+
+    // The caller's buffers may change right after the call
+    uint8_t data[] = {0xde, 0xad, 0xbe, 0xef};
+    auto format_bytes = mould::compile<bytes>();
+    for(int i = 0; i < 3; i++) {
+      mould::async_write(format_bytes, *sink, std::span<const uint8_t>{data});
+      std::memset(data, 0, sizeof(data));
+      data[0] = 0xde, data[1] = 0xad, data[2] = 0xbe, data[3] = 0xef;
+    }
+    pool.flush();
+    std::memset(data, 0, sizeof(data));
+
+    std::string text = "text";
+    auto format_line = mould::compile<line>();
+    mould::async_write(format_line, *sink, 1, text.c_str(), std::string_view{text});
+    text.assign(32, 'x');
+
+    auto format_named = mould::compile<named>();
+    std::string name = "key";
+    mould::async_write(format_named, *sink, mould::arg<"value">(7), mould::arg<"name">(name.c_str()));
+    name.assign(32, 'y');
+  }
+  test::expect("async", output.str(), "deadbeef|deadbeef|deadbeef|1 text text|key=7|");
+
+  // Calls beyond the capacity are counted when they are dropped
+  std::ostringstream dropped;
+  {
+    mould::AsyncPool pool{1};
+    mould::AsyncSink* sink = pool.add_sink(dropped, mould::Backpressure::Count, 2);
+    auto format_line = mould::compile<line>();
+    size_t queued = 0;
+    for(int i = 0; i < 1000; i++)
+      queued += mould::async_write(format_line, *sink, i, "a", "b");
+    pool.flush();
+    test::expect("dropped", queued + sink->dropped() == 1000);
+  }
+  return test::result();
+}
@@ -0,0 +1,33 @@
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "check.hpp"
+
+static constexpr char record[] = "{},{:.3f},{:>12},{:08d}\n";
+
+int main() {
+  // Batches give the output of formatting the records one after another,
+  // with any number of threads
+  using Record = std::tuple<int, double, std::string, int>;
+  std::vector<Record> records;
+  for(int i = 0; i < 20000; i++)
+    records.emplace_back(i*7 - 1000, i/3.0, std::string(i % 23, 'a' + i % 26), i % 100000);
+
+  auto format_record = mould::compile<record>();
+  std::string serial = "head\n";
+  for(const auto& values : records) {
+    std::apply([&](const auto& ... arguments) {
+      mould::format_constexpr(format_record, serial, arguments...);
+    }, values);
+  }
+  for(unsigned threads : { 1u, 3u, 8u, 0u }) {
+    std::string output = "head\n";
+    mould::format_batch(format_record, records, output, threads);
+    test::expect("batch " + std::to_string(threads), output == serial);
+  }
+  std::string empty;
+  mould::format_batch(format_record, std::vector<Record>{}, empty);
+  test::expect("empty batch", empty, "");
+  return test::result();
+}
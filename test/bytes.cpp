@@ -0,0 +1,91 @@
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+
+static constexpr char hex[] = "{}|{:X}";
+static constexpr char dump[] = "{:h}|{:.2h}|{:.3h}|{:.4h}|{:.16h}";
+static constexpr char base64[] = "{:m}";
+static constexpr char base64_width[] = "[{:>20m}]";
+
+// Scalar references, one byte or group of three at a time
+std::string reference_hex(std::span<const uint8_t> bytes, bool upper, size_t group = 0) {
+  std::string output;
+  char digits[3];
+  for(size_t i = 0; i < bytes.size(); i++) {
+    if(group && i && i % group == 0)
+      output += ' ';
+    std::snprintf(digits, sizeof(digits), upper ? "%02X" : "%02x", bytes[i]);
+    output += digits;
+  }
+  return output;
+}
+
+std::string reference_base64(std::span<const uint8_t> bytes) {
+  constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string output;
+  for(size_t i = 0; i < bytes.size(); i += 3) {
+    const size_t left = bytes.size() - i;
+    const uint32_t bits = uint32_t{bytes[i]} << 16
+      | (left > 1 ? uint32_t{bytes[i + 1]} << 8 : 0) | (left > 2 ? bytes[i + 2] : 0);
+    output += alphabet[bits >> 18 & 0x3F];
+    output += alphabet[bits >> 12 & 0x3F];
+    output += left > 1 ? alphabet[bits >> 6 & 0x3F] : '=';
+    output += left > 2 ? alphabet[bits & 0x3F] : '=';
+  }
+  return output;
+}
+
+// Through both drivers, and the stream engine that encodes into its buffer
+template<typename Format, typename ... Arguments>
+void expect_encoded(std::string_view name, Format& format, std::string_view expected, const Arguments& ... arguments) {
+  test::expect_format(name, format, expected, arguments...);
+  std::ostringstream stream;
+  mould::write_constexpr(format, stream, arguments...);
+  test::expect(name, stream.str(), expected);
+}
+
+int main() {
+  auto format_hex = mould::compile<hex>();
+  auto format_dump = mould::compile<dump>();
+  auto format_base64 = mould::compile<base64>();
+  auto format_base64_width = mould::compile<base64_width>();
+
+  // Every length around the vector steps of 12 and 16 bytes, with all byte
+  // values, and some longer than the chunks of the append path
+  uint32_t state = 7;
+  for(size_t length : { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20,
+      21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 255, 1500 })
+  {
+    for(int round = 0; round < 8; round++) {
+      std::vector<uint8_t> bytes(length);
+      for(auto& byte : bytes) {
+        state = state*1103515245 + 12345;
+        byte = static_cast<uint8_t>(round == 0 ? 0xFF : round == 1 ? 0 : state >> 16);
+      }
+      const std::span<const uint8_t> span{bytes};
+      const std::span<const std::byte> byte_span = std::as_bytes(span);
+      const std::string name = "length " + std::to_string(length);
+
+      expect_encoded(name + " hex", format_hex,
+        reference_hex(span, false) + "|" + reference_hex(span, true), span, byte_span);
+      expect_encoded(name + " dump", format_dump,
+        reference_hex(span, false, 1) + "|" + reference_hex(span, false, 2) + "|"
+        + reference_hex(span, false, 3) + "|" + reference_hex(span, false, 4) + "|"
+        + reference_hex(span, false, 16),
+        span, byte_span, span, span, span);
+      expect_encoded(name + " base64", format_base64, reference_base64(span), span);
+      expect_encoded(name + " base64 bytes", format_base64, reference_base64(span), byte_span);
+
+      std::string padded = reference_base64(span);
+      if(padded.size() < 20)
+        padded.insert(0, 20 - padded.size(), ' ');
+      expect_encoded(name + " base64 width", format_base64_width, "[" + padded + "]", span);
+    }
+  }
+  return test::result();
+}
@@ -0,0 +1,45 @@
+#ifndef CPP_MOULD_TEST_CHECK_HPP
+#define CPP_MOULD_TEST_CHECK_HPP
+/* Shared by the behavior tests, each a program that returns the number of
+ * failed checks.
+ */
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include <cpp_mould.hpp>
+
+namespace test {
+  inline int failures = 0;
+
+  inline void expect(std::string_view name, std::string_view output, std::string_view expected) {
+    if(output == expected)
+      return;
+    failures++;
+    std::cout << name << ": got [" << output << "] expected [" << expected << "]\n";
+  }
+
+  inline void expect(std::string_view name, bool condition) {
+    if(condition)
+      return;
+    failures++;
+    std::cout << name << ": failed\n";
+  }
+
+  // Both drivers give the same output
+  template<typename Format, typename ... Arguments>
+  void expect_format(std::string_view name, Format& format, std::string_view expected, const Arguments& ... arguments) {
+    std::string output;
+    mould::format_constexpr(format, output, arguments...);
+    expect(name, output, expected);
+    expect(name, mould::format(format, arguments...), expected);
+  }
+
+  inline int result() {
+    if(!failures)
+      std::cout << "ok\n";
+    return failures;
+  }
+}
+
+#endif
@@ -0,0 +1,48 @@
+#include <chrono>
+
+#include "check.hpp"
+
+static constexpr char fractions[] = "{:%3f %3f %3f %3f %3f}";
+static constexpr char four[] = "{:%S.%3f %1f %2f %6f}";
+static constexpr char stamp[] = "[{:%F %T.%3f}]";
+static constexpr char padded[] = "[{:>12%T}]";
+static constexpr char elapsed[] = "{:%H:%M:%S.%3f}|{}";
+
+int main() {
+  using namespace std::chrono;
+  const sys_time<milliseconds> time{milliseconds{1234}};
+
+  // More fraction fields than the cache records are all written
+  auto format_fractions = mould::compile<fractions>();
+  test::expect_format("five fractions", format_fractions, "234 234 234 234 234", time);
+  test::expect_format("five fractions again", format_fractions, "567 567 567 567 567",
+    time + milliseconds{333});
+
+  auto format_four = mould::compile<four>();
+  test::expect_format("four fractions", format_four, "01.234 2 23 234000", time);
+  test::expect_format("four fractions cached", format_four, "01.999 9 99 999000",
+    time + milliseconds{765});
+
+  auto format_stamp = mould::compile<stamp>();
+  test::expect_format("stamp", format_stamp, "[1970-01-01 00:00:01.234]", time);
+  test::expect_format("stamp before epoch", format_stamp, "[1969-12-31 23:59:58.766]",
+    sys_time<milliseconds>{milliseconds{-1234}});
+
+  auto format_padded = mould::compile<padded>();
+  test::expect_format("padded", format_padded, "[    00:00:01]", time);
+
+  auto format_duration = mould::compile<elapsed>();
+  test::expect_format("duration", format_duration, "01:01:01.500|-1500ms",
+    milliseconds{3661500}, milliseconds{-1500});
+  test::expect_format("duration below second", format_duration, "-00:00:00.001|-1ms",
+    milliseconds{-1}, milliseconds{-1});
+
+  // The minimum is negated without overflow
+  test::expect_format("duration minimum", format_duration,
+    "-2562047:47:16.854|-9223372036854775808ns", nanoseconds::min(), nanoseconds::min());
+  test::expect_format("duration int minimum", format_duration,
+    "-596:31:23.648|-2147483648ms", duration<int, std::milli>::min(), duration<int, std::milli>::min());
+  test::expect_format("duration seconds minimum", format_duration,
+    "-2562047788015215:30:08.000|-9223372036854775808s", seconds::min(), seconds::min());
+  return test::result();
+}
@@ -0,0 +1,52 @@
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+
+static constexpr char row[] = "{}\t{:.2f}\t{}\t{:08d}\t{}\t{:d};\n";
+static constexpr char number[] = "{}";
+
+int main() {
+  // Columns give the output of the rows, also at the limits of the integer
+  // kernels
+  const size_t rows = 10007;
+  std::vector<int64_t> wide(rows);
+  std::vector<double> reals(rows);
+  std::vector<std::string> texts(rows);
+  std::vector<int> padded(rows), narrow(rows);
+  std::vector<uint64_t> unsigned_wide(rows);
+  uint64_t state = 3;
+  for(size_t i = 0; i < rows; i++) {
+    state = state*6364136223846793005ull + 1442695040888963407ull;
+    wide[i] = static_cast<int64_t>(state) >> (state % 64);
+    reals[i] = (state % 100000)/7.0;
+    texts[i] = std::string(state % 5, 'q');
+    padded[i] = static_cast<int>(state % 1000000) - 500000;
+    narrow[i] = static_cast<int>(state >> 32) >> (state % 32);
+    unsigned_wide[i] = state >> (state % 64);
+  }
+  wide[0] = LLONG_MIN, wide[1] = LLONG_MAX, wide[2] = 0, wide[3] = -99999999, wide[4] = 100000000;
+  narrow[5] = INT_MIN, unsigned_wide[6] = ULLONG_MAX, unsigned_wide[7] = 0;
+
+  auto format_row = mould::compile<row>();
+  std::string expected = "x";
+  for(size_t i = 0; i < rows; i++)
+    mould::format_constexpr(format_row, expected, wide[i], reals[i], texts[i], padded[i], narrow[i], unsigned_wide[i]);
+  std::string columns = "x";
+  mould::format_columns(format_row, columns, wide, reals, texts, padded, narrow, unsigned_wide);
+  test::expect("columns", columns == expected);
+
+  auto format_number = mould::compile<number>();
+  std::string numbers, number_columns;
+  for(int64_t value : wide)
+    mould::format_constexpr(format_number, numbers, value);
+  mould::format_columns(format_number, number_columns, wide);
+  test::expect("number column", number_columns == numbers);
+
+  std::string no_rows;
+  mould::format_columns(format_row, no_rows, std::vector<int64_t>{}, reals, texts, padded, narrow, unsigned_wide);
+  test::expect("no rows", no_rows, "");
+  return test::result();
+}
@@ -0,0 +1,49 @@
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "check.hpp"
+
+static constexpr char values[] = "{} + {:.2f} = {:>6}|";
+static constexpr char bytes[] = "{:x}|";
+static constexpr char range[] = "{}|";
+
+// Formats all records of `records`
+std::string format_all(const std::string& records) {
+  std::string output;
+  size_t at = 0;
+  while(size_t length = mould::format_deferred(output, records.data() + at, records.size() - at))
+    at += length;
+  test::expect("whole records", at == records.size());
+  return output;
+}
+
+int main() {
+  std::string records;
+  {
+    std::string text = "lit";
+    mould::defer(mould::compile<values>(), 1, 2.5, text).append_to(records);
+    text = "changed";
+  }
+  test::expect("values", format_all(records), "1 + 2.50 =    lit|");
+
+  // Spans are copied with their elements, not as pointer
+  records.clear();
+  {
+    uint8_t data[] = {0xde, 0xad, 0xbe, 0xef};
+    mould::defer(mould::compile<bytes>(), std::span<const uint8_t>{data}).append_to(records);
+    std::vector<int> numbers = {1, 2, 3};
+    mould::defer(mould::compile<range>(), std::span<const int>{numbers}).append_to(records);
+    std::fill(std::begin(data), std::end(data), 0);
+    numbers.assign(64, 7);
+  }
+  test::expect("spans", format_all(records), "deadbeef|[1, 2, 3]|");
+
+  // An empty span
+  records.clear();
+  mould::defer(mould::compile<range>(), std::span<const int>{}).append_to(records);
+  test::expect("empty span", format_all(records), "[]|");
+
+  test::expect("truncated record", mould::format_deferred(records, records.data(), 5) == 0);
+  return test::result();
+}
@@ -0,0 +1,38 @@
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "check.hpp"
+
+enum class Color : int8_t { red, green, blue };
+template<> struct mould::EnumNames<Color> {
+  static constexpr std::string_view names[] = { "red", "green", "blue" };
+};
+
+enum class Wide : int64_t { zero };
+template<> struct mould::EnumNames<Wide> {
+  static constexpr std::string_view names[] = { "zero" };
+};
+
+static constexpr char value[] = "{}|";
+static constexpr char aligned[] = "{:>7}|";
+
+int main() {
+  auto format_value = mould::compile<value>();
+  test::expect_format("name", format_value, "green|", Color::green);
+  test::expect_format("unnamed", format_value, "7|", Color(7));
+  test::expect_format("negative", format_value, "-3|", Color(-3));
+  test::expect_format("range", format_value, "[red, blue]|", std::vector<Color>{Color::red, Color::blue});
+  test::expect_format("bool", format_value, "true|", true);
+
+  // The minimum is negated without overflow
+  test::expect_format("minimum", format_value, "-9223372036854775808|",
+    Wide(std::numeric_limits<int64_t>::min()));
+  test::expect_format("maximum", format_value, "9223372036854775807|",
+    Wide(std::numeric_limits<int64_t>::max()));
+
+  auto format_aligned = mould::compile<aligned>();
+  test::expect_format("aligned", format_aligned, "    red|", Color::red);
+  test::expect_format("aligned bool", format_aligned, "  false|", false);
+  return test::result();
+}
@@ -0,0 +1,100 @@
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "check.hpp"
+
+static constexpr char json[] = "{:j}";
+static constexpr char quoted[] = "{:q}";
+static constexpr char json_precision[] = "{:.3j}|{:.2q}";
+static constexpr char json_width[] = "[{:>12j}]";
+static constexpr char quoted_width[] = "[{:<12q}]";
+
+// Escapes one byte at a time, as the formatters should
+std::string reference(std::string_view value, bool json) {
+  std::string output = "\"";
+  for(char chr : value) {
+    const auto byte = static_cast<unsigned char>(chr);
+    switch(chr) {
+    case '"': output += "\\\""; continue;
+    case '\\': output += "\\\\"; continue;
+    case '\b': output += "\\b"; continue;
+    case '\f': output += "\\f"; continue;
+    case '\n': output += "\\n"; continue;
+    case '\r': output += "\\r"; continue;
+    case '\t': output += "\\t"; continue;
+    }
+    char escape[8];
+    if(json && byte < 0x20) {
+      std::snprintf(escape, sizeof(escape), "\\u%04x", byte);
+      output += escape;
+    } else if(!json && (chr == '\a' || chr == '\v')) {
+      output += chr == '\a' ? "\\a" : "\\v";
+    } else if(!json && (byte < 0x20 || byte == 0x7F)) {
+      std::snprintf(escape, sizeof(escape), "\\%03o", byte);
+      output += escape;
+    } else {
+      output += chr;
+    }
+  }
+  return output + "\"";
+}
+
+// The string engines append the output in pieces, the stream engine offers
+// its buffer with show_buf while the escaped string fits
+template<typename Format, typename ... Arguments>
+void expect_escaped(std::string_view name, Format& format, std::string_view expected, const Arguments& ... arguments) {
+  test::expect_format(name, format, expected, arguments...);
+  std::ostringstream stream;
+  mould::write_constexpr(format, stream, arguments...);
+  test::expect(name, stream.str(), expected);
+}
+
+int main() {
+  auto format_json = mould::compile<json>();
+  auto format_quoted = mould::compile<quoted>();
+
+  expect_escaped("json plain", format_json, "\"abc\"", "abc");
+  expect_escaped("json empty", format_json, "\"\"", std::string{});
+  expect_escaped("json quotes", format_json, R"("a\"b\\c")", "a\"b\\c");
+  expect_escaped("json short forms", format_json, R"("\b\f\n\r\t")", "\b\f\n\r\t");
+  expect_escaped("json control", format_json, R"("\u0000\u0001\u0007\u000b\u001f")",
+    std::string_view{"\0\x01\a\v\x1f", 5});
+  expect_escaped("json 7f", format_json, "\"\x7f\"", "\x7f");
+  expect_escaped("json utf-8", format_json, "\"gr\xc3\xbc\xc3\x9f \xe2\x82\xac\"", "gr\xc3\xbc\xc3\x9f \xe2\x82\xac");
+
+  expect_escaped("c quotes", format_quoted, R"("a\"b\\c")", std::string("a\"b\\c"));
+  expect_escaped("c short forms", format_quoted, R"("\a\b\f\n\r\t\v")", "\a\b\f\n\r\t\v");
+  // Octal escapes always have three digits, a digit after them is no part
+  expect_escaped("c control", format_quoted, R"("\000\0012\037")", std::string_view{"\0\x01" "2\x1f", 4});
+  expect_escaped("c 7f", format_quoted, R"("\177")", "\x7f");
+  expect_escaped("c utf-8", format_quoted, "\"\xc3\xa9\"", "\xc3\xa9");
+
+  // The precision takes characters from the string, the width pads the
+  // quoted result
+  auto format_precision = mould::compile<json_precision>();
+  expect_escaped("precision", format_precision, R"("a\nb"|"\"x")", "a\nbcd", std::string_view{"\"xyz"});
+  auto format_json_width = mould::compile<json_width>();
+  expect_escaped("json width", format_json_width, R"([      "a\tb"])", "a\tb");
+  expect_escaped("json wider", format_json_width, R"(["\u0001\u0002\u0003"])", "\x01\x02\x03");
+  auto format_quoted_width = mould::compile<quoted_width>();
+  expect_escaped("c width", format_quoted_width, R"(["\001"      ])", "\x01");
+
+  // Longer than the stream buffer, such that the stream engine appends too
+  const std::string long_text = std::string(150, '\n') + "end";
+  expect_escaped("long width", format_json_width, "[" + reference(long_text, true) + "]", long_text);
+
+  // An escape at every offset of strings longer than one vector block
+  for(size_t length = 1; length < 80; length++) {
+    for(size_t at = 0; at < length; at++) {
+      for(char escape : { '"', '\\', '\x01', '\x1f', '\x7f' }) {
+        std::string text(length, 'a' + length % 26);
+        text[at] = escape;
+        const std::string name = "offset " + std::to_string(length) + " " + std::to_string(at);
+        expect_escaped(name, format_json, reference(text, true), text);
+        expect_escaped(name, format_quoted, reference(text, false), text);
+      }
+    }
+  }
+  return test::result();
+}
@@ -0,0 +1,69 @@
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+
+static constexpr char value[] = "{}|";
+static constexpr char two[] = "{:.2f}|";
+static constexpr char whole[] = "{:.0f}|";
+static constexpr char six[] = "{:.6f}|";
+static constexpr char grouped[] = "{:,.2f}|{:,}|{:_.0f}";
+static constexpr char aligned[] = "{:>+14,.2f}|";
+static constexpr char dynamic[] = "{:.{}f}";
+static constexpr char above[] = "{:.65f}";
+
+int main() {
+  using mould::fixed;
+  constexpr int64_t minimum = std::numeric_limits<int64_t>::min();
+  constexpr int64_t maximum = std::numeric_limits<int64_t>::max();
+
+  auto format_value = mould::compile<value>();
+  test::expect_format("scale", format_value, "1234.5678|", fixed<4>(12345678));
+  test::expect_format("below one", format_value, "-0.0005|", fixed<4>(-5));
+  test::expect_format("no scale", format_value, "42|", fixed<0>(42));
+  test::expect_format("zero", format_value, "0.00|", fixed<2>(0));
+  test::expect_format("minimum", format_value, "-9.223372036854775808|", fixed<18>(minimum));
+  test::expect_format("range", format_value, "[0.01, -2.50]|", std::vector{fixed<2>(1), fixed<2>(-250)});
+
+  // Halfway cases round to even, anything above half rounds up
+  auto format_two = mould::compile<two>();
+  test::expect_format("round", format_two, "1234.57|", fixed<4>(12345678));
+  test::expect_format("half down", format_two, "0.12|", fixed<3>(125));
+  test::expect_format("half up", format_two, "0.14|", fixed<3>(135));
+  test::expect_format("above half", format_two, "1.25|", fixed<3>(1251));
+  test::expect_format("negative half down", format_two, "-0.12|", fixed<3>(-125));
+  test::expect_format("negative half up", format_two, "-0.14|", fixed<3>(-135));
+  test::expect_format("negative above half", format_two, "-1.25|", fixed<3>(-1251));
+  test::expect_format("maximum", format_two, "92233720368547758.07|", fixed<2>(maximum));
+  auto format_whole = mould::compile<whole>();
+  test::expect_format("whole half down", format_whole, "2|", fixed<1>(25));
+  test::expect_format("whole half up", format_whole, "4|", fixed<1>(35));
+  test::expect_format("whole carry", format_whole, "-100|", fixed<1>(-999));
+  test::expect_format("whole to zero", format_whole, "-0|", fixed<1>(-4));
+  test::expect_format("whole maximum", format_whole, "9|", fixed<18>(maximum));
+  test::expect_format("whole minimum", format_whole, "-9|", fixed<18>(minimum));
+
+  // Fraction digits beyond the scale are zeros
+  auto format_six = mould::compile<six>();
+  test::expect_format("beyond scale", format_six, "-1.500000|", fixed<2>(-150));
+  test::expect_format("beyond no scale", format_six, "7.000000|", fixed<0>(7));
+
+  auto format_grouped = mould::compile<grouped>();
+  test::expect_format("grouped", format_grouped, "1,234,567.89|-1,234.5|1_234_568",
+    fixed<2>(123456789), fixed<1>(-12345), fixed<1>(12345675));
+  test::expect_format("grouped minimum", format_grouped,
+    "-92,233,720,368,547,758.08|-922,337,203,685,477,580.8|-9_223_372_036_854_775_808",
+    fixed<2>(minimum), fixed<1>(minimum), fixed<0>(minimum));
+  auto format_aligned = mould::compile<aligned>();
+  test::expect_format("aligned", format_aligned, "    +12,345.68|", fixed<3>(12345675));
+
+  // Up to 64 fraction digits, more are an error
+  auto format_dynamic = mould::compile<dynamic>();
+  test::expect_format("largest precision", format_dynamic, "0.5" + std::string(63, '0'), fixed<1>(5), 64);
+  test::expect("above precision", mould::format(format_dynamic, fixed<1>(5), 65), "Error while formatting");
+  auto format_above = mould::compile<above>();
+  test::expect("above static precision", mould::format(format_above, fixed<1>(5)), "Error while formatting");
+  return test::result();
+}
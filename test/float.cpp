@@ -0,0 +1,71 @@
+#include <cstdio>
+#include <limits>
+#include <string>
+
+#include "check.hpp"
+
+static constexpr char general[] = "{:g}|{:.3g}|{:G}";
+static constexpr char general_precision[] = "{:.{}g}";
+static constexpr char large_precision[] = "{:.70g}";
+static constexpr char fixed_precision[] = "{:.{}f}";
+static constexpr char fixed_hundred[] = "{:.100f}";
+static constexpr char grouped[] = "{:,.2f}|{:.1%}";
+
+// The output of printf for the same conversion
+std::string printf_double(const char* conversion, double value, int precision) {
+  char buffer[2048];
+  const int length = std::snprintf(buffer, sizeof(buffer), conversion, precision, value);
+  return {buffer, static_cast<size_t>(length)};
+}
+
+int main() {
+  // The largest precision depends on the backend
+  constexpr int maximum = mould::internal::max_double_precision;
+
+  auto format_general = mould::compile<general>();
+  auto format_precision = mould::compile<general_precision>();
+  test::expect_format("general", format_general, "0.0001|1.23e+05|1E-05", 0.0001, 123456.0, 0.00001);
+  test::expect_format("general fixed", format_general, "100000|0.5|1.5", 100000.0, 0.5, 1.5);
+
+  // Infinity and NaN are spelled as by printf, whatever the backend writes
+  constexpr double infinity = std::numeric_limits<double>::infinity();
+  constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+  test::expect_format("general special", format_general, "inf|-0|NAN", infinity, -0.0, nan);
+  test::expect_format("general negative special", format_general, "-inf|-nan|-INF", -infinity, -nan, -infinity);
+  test::expect_format("general special precision", format_precision, "inf", infinity, maximum);
+
+  // The notation follows the precision also beyond the digits of a double
+  auto format_large = mould::compile<large_precision>();
+  test::expect_format("large precision", format_large, printf_double("%.*g", 1e65, 70), 1e65);
+
+  for(int precision : { 0, 1, 17, 64, 66, 100, 300, 400, 1074 }) {
+    if(precision > maximum)
+      continue;
+    for(double value : { 1e65, 1e-300, 0.1, 123456789.0, 5e-324 }) {
+      test::expect_format("precision " + std::to_string(precision), format_precision,
+        printf_double("%.*g", value, precision), value, precision);
+    }
+  }
+
+  test::expect("above maximum", mould::format(format_precision, 1.5, maximum + 1), "Error while formatting");
+
+  // All fraction digits are written, not only those of the first 64
+  auto format_hundred = mould::compile<fixed_hundred>();
+  test::expect_format("fixed 100", format_hundred, printf_double("%.*f", 0.1, 100), 0.1);
+
+  auto format_fixed = mould::compile<fixed_precision>();
+  for(int precision : { 0, 2, 64, 65, 100, 200, 1074 }) {
+    if(precision > maximum)
+      continue;
+    // Fixed notation also from 1e60 on
+    for(double value : { 0.1, -2.5, 1e59, 1e60, -1e65, 1e300, 5e-324 }) {
+      test::expect_format("fixed " + std::to_string(precision), format_fixed,
+        printf_double("%.*f", value, precision), value, precision);
+    }
+  }
+  test::expect("fixed above maximum", mould::format(format_fixed, 0.1, maximum + 1), "Error while formatting");
+
+  auto format_grouped = mould::compile<grouped>();
+  test::expect_format("grouped", format_grouped, "1,234,567.89|12.5%", 1234567.891, 0.125);
+  return test::result();
+}
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <cpp_mould/arguments/float_backend/double_conversion.hpp>
+#include <cpp_mould/arguments/float_backend/dragonbox.hpp>
+#include <cpp_mould/arguments/float_backend/ryu.hpp>
+
+/* Compares the float backends selectable with CPP_MOULD_FLOAT_SHORTEST and
+ * CPP_MOULD_FLOAT_FIXED, in nanoseconds per formatted value.
+ */
+
+static constexpr size_t value_count = 1 << 18;
+static constexpr int rounds = 8;
+
+static std::vector<double> small_integers(std::mt19937_64& rng) {
+  std::vector<double> values(value_count);
+  for(auto& value : values) value = static_cast<double>(rng() % 10000);
+  return values;
+}
+
+static std::vector<double> prices(std::mt19937_64& rng) {
+  std::vector<double> values(value_count);
+  for(auto& value : values) value = static_cast<double>(rng() % 10000000) / 100.0;
+  return values;
+}
+
+static std::vector<double> random_bits(std::mt19937_64& rng) {
+  std::vector<double> values(value_count);
+  for(auto& value : values) {
+    do {
+      const std::uint64_t bits = rng();
+      std::memcpy(&value, &bits, sizeof(value));
+    } while(!std::isfinite(value));
+  }
+  return values;
+}
+
+template<typename Fn>
+static double nanoseconds_per_value(const std::vector<double>& values, Fn&& fn) {
+  char buffer[128];
+  size_t checksum = 0;
+  auto best = std::chrono::nanoseconds::max();
+
+  for(int round = 0; round < rounds; round++) {
+    const auto start = std::chrono::steady_clock::now();
+    for(const double value : values)
+      checksum += static_cast<size_t>(fn(buffer, value) - buffer) + buffer[0];
+    const auto took = std::chrono::steady_clock::now() - start;
+    best = std::min(best, std::chrono::duration_cast<std::chrono::nanoseconds>(took));
+  }
+
+  // Keep the formatting observable.
+  if(checksum == 0) std::cerr << "";
+  return static_cast<double>(best.count()) / values.size();
+}
+
+template<typename Backend>
+static void run(const char* name, const char* distribution, const std::vector<double>& values, bool fixed) {
+  std::cout << std::left << std::setw(18) << name << std::setw(16) << distribution;
+
+  if constexpr(Backend::has_shortest) {
+    std::cout << std::right << std::setw(10) << std::fixed << std::setprecision(1)
+      << nanoseconds_per_value(values, Backend::shortest);
+  } else {
+    std::cout << std::right << std::setw(10) << "-";
+  }
+
+  if constexpr(Backend::has_precision) {
+    if(fixed) {
+      std::cout << std::setw(10) << nanoseconds_per_value(values,
+        [](char* buffer, double value) { return Backend::fixed(buffer, value, 2); });
+    } else {
+      std::cout << std::setw(10) << "-";
+    }
+    std::cout << std::setw(10) << nanoseconds_per_value(values,
+      [](char* buffer, double value) { return Backend::exponent(buffer, value, 6); });
+  } else {
+    std::cout << std::setw(10) << "-" << std::setw(10) << "-";
+  }
+
+  std::cout << "\n";
+}
+
+int main() {
+  std::mt19937_64 rng { 0x6d6f756c64 };
+
+  struct Distribution {
+    const char* name;
+    std::vector<double> values;
+    // Fixed notation of arbitrary bit patterns prints hundreds of digits.
+    bool fixed;
+  };
+
+  const Distribution distributions[] = {
+    { "small integers", small_integers(rng), true },
+    { "prices", prices(rng), true },
+    { "random bits", random_bits(rng), false },
+  };
+
+  std::cout << std::left << std::setw(18) << "backend" << std::setw(16) << "values"
+    << std::right << std::setw(10) << "shortest" << std::setw(10) << ".2f"
+    << std::setw(10) << ".6e" << "   (ns/value)\n";
+
+  for(const auto& distribution : distributions) {
+    run<mould::float_backend::Ryu>("ryu", distribution.name, distribution.values, distribution.fixed);
+    run<mould::float_backend::Dragonbox>("dragonbox", distribution.name, distribution.values, distribution.fixed);
+    run<mould::float_backend::DoubleConversion>("double-conversion", distribution.name, distribution.values, distribution.fixed);
+  }
+}
@@ -0,0 +1,116 @@
+/* Without arguments tests the registry and its table. With the path of a
+ * table written by `mould::format_table` maps it and prints the formats and
+ * their constant data.
+ */
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "check.hpp"
+
+static constexpr char sum[] = "{} + {}|";
+static constexpr char word[] = "<{:>4}>";
+
+// Prints the table at `path`, 1 if it can not be mapped
+int print_table(const char* path) {
+  const int file = open(path, O_RDONLY);
+  struct stat info;
+  if(file < 0 || fstat(file, &info) != 0 || info.st_size == 0) {
+    std::cout << path << ": can not be read\n";
+    return 1;
+  }
+  void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+  close(file);
+  if(mapped == MAP_FAILED) {
+    std::cout << path << ": can not be mapped\n";
+    return 1;
+  }
+
+  const mould::FormatTable table({static_cast<const char*>(mapped), static_cast<size_t>(info.st_size)});
+  for(const mould::FormatTableEntry& entry : table.entries()) {
+    std::printf("%016llx %.*s [%.*s]\n", static_cast<unsigned long long>(entry.id),
+      static_cast<int>(entry.format_length), table.format(entry).data(),
+      static_cast<int>(entry.signature_length), table.signature(entry).data());
+  }
+  std::cout << table.entries().size() << " formats, " << table.footprint() << " bytes of constant data\n";
+  munmap(mapped, info.st_size);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if(argc > 1)
+    return print_table(argv[1]);
+
+  auto sum_format = mould::compile<sum>();
+  auto word_format = mould::compile<word>();
+  std::string output;
+  mould::format_constexpr(sum_format, output, 1, 2);
+  mould::format_constexpr(word_format, output, "ab");
+  mould::defer(sum_format, 1, 2).append_to(output);
+
+  const auto formats = mould::registered_formats();
+#ifdef CPP_MOULD_HAS_REGISTRY
+  test::expect("count", formats.size() == 2);
+#endif
+  for(size_t i = 1; i < formats.size(); i++)
+    test::expect("sorted", formats[i - 1]->id < formats[i]->id);
+
+  // The use by `defer` keeps its decoder, the driver registers none
+  constexpr uint64_t sum_id = mould::internal::format_id<decltype(sum_format), int, int>();
+  const mould::FormatRegistration* deferred = mould::find_format(sum_id);
+#ifdef CPP_MOULD_HAS_REGISTRY
+  test::expect("deferred", deferred && deferred->decode);
+#endif
+
+  // The table is 8 aligned as a mapping would be
+  const std::string written = mould::format_table();
+  std::vector<uint64_t> aligned((written.size() + 7)/8);
+  std::memcpy(aligned.data(), written.data(), written.size());
+  const mould::FormatTable table({reinterpret_cast<const char*>(aligned.data()), written.size()});
+  test::expect("entries", table.entries().size() == formats.size());
+  size_t footprint = 0;
+  for(const mould::FormatRegistration* format : formats) {
+    footprint += format->footprint();
+    const mould::FormatTableEntry* entry = table.find(format->id);
+    test::expect("found", entry != nullptr);
+    if(!entry)
+      continue;
+    test::expect("format", table.format(*entry), {format->format, format->format_length});
+    test::expect("signature", table.signature(*entry), {format->signature, format->signature_length});
+    test::expect("code", std::equal(table.code(*entry).begin(), table.code(*entry).end(), format->code));
+    test::expect("immediates", table.immediates(*entry).size() == format->immediate_length);
+  }
+  test::expect("footprint", table.footprint() == footprint);
+  test::expect("missing", table.find(sum_id + 1) == nullptr);
+  test::expect("not a table", mould::FormatTable({written.data(), 4}).entries().empty());
+  test::expect("unaligned", mould::FormatTable({reinterpret_cast<const char*>(aligned.data()) + 1,
+    written.size() - 1}).entries().empty());
+  test::expect("truncated", mould::FormatTable({reinterpret_cast<const char*>(aligned.data()),
+    written.size() - 1}).entries().empty());
+
+  // A table with a changed first entry is rejected as a whole
+  const auto rejected = [&](auto change) {
+    std::vector<uint64_t> copy = aligned;
+    auto* entries = reinterpret_cast<mould::FormatTableEntry*>(
+      reinterpret_cast<char*>(copy.data()) + sizeof(mould::FormatTableHeader));
+    change(entries[0]);
+    return mould::FormatTable({reinterpret_cast<const char*>(copy.data()), written.size()}).entries().empty();
+  };
+  const uint32_t size = static_cast<uint32_t>(written.size());
+  if(formats.size() >= 2) {
+    test::expect("valid copy", !rejected([](mould::FormatTableEntry&) {}));
+    test::expect("format outside", rejected([size](auto& entry) { entry.format_offset = size; entry.format_length = 1; }));
+    test::expect("signature outside", rejected([size](auto& entry) { entry.signature_length = size; }));
+    test::expect("code outside", rejected([size](auto& entry) { entry.code_length = size; }));
+    test::expect("immediates outside", rejected([size](auto& entry) { entry.immediate_length = size/8; }));
+    test::expect("offset overflow", rejected([](auto& entry) {
+      entry.format_offset = 0xFFFFFFF0u;
+      entry.format_length = 0x20;
+    }));
+    test::expect("immediates unaligned", rejected([](auto& entry) { entry.immediates_offset += 4; }));
+    test::expect("not sorted", rejected([](auto& entry) { entry.id = ~uint64_t{0}; }));
+  }
+  return test::result();
+}
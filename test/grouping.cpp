@@ -0,0 +1,42 @@
+#include <climits>
+#include <vector>
+
+#include "check.hpp"
+
+static constexpr char comma[] = "{:,}|";
+static constexpr char underscore[] = "{:_d}|";
+static constexpr char aligned[] = "{:>12,}|";
+static constexpr char sign[] = "{:+,}|";
+static constexpr char fixed[] = "{:,.2f}|";
+static constexpr char fixed_aligned[] = "{:>15_f}|";
+static constexpr char plain[] = "{}|{:.1f}|";
+
+int main() {
+  auto format_comma = mould::compile<comma>();
+  test::expect_format("zero", format_comma, "0|", 0);
+  test::expect_format("three digits", format_comma, "999|", 999);
+  test::expect_format("four digits", format_comma, "1,000|", 1000);
+  test::expect_format("negative", format_comma, "-1,234,567|", -1234567);
+  test::expect_format("minimum", format_comma, "-2,147,483,648|", INT_MIN);
+  test::expect_format("maximum", format_comma, "18,446,744,073,709,551,615|", ULLONG_MAX);
+  test::expect_format("range", format_comma, "[1,000, 2,000,000]|", std::vector<int>{1000, 2000000});
+
+  auto format_underscore = mould::compile<underscore>();
+  test::expect_format("underscore", format_underscore, "123_456|", 123456);
+  auto format_aligned = mould::compile<aligned>();
+  test::expect_format("aligned", format_aligned, "     -12,345|", -12345);
+  auto format_sign = mould::compile<sign>();
+  test::expect_format("sign", format_sign, "+100,000|", 100000);
+
+  auto format_fixed = mould::compile<fixed>();
+  test::expect_format("fixed", format_fixed, "1,234,567.89|", 1234567.891);
+  test::expect_format("fixed negative", format_fixed, "-999.50|", -999.5);
+  test::expect_format("fixed thousand", format_fixed, "-1,000.00|", -1000.0);
+  auto format_fixed_aligned = mould::compile<fixed_aligned>();
+  test::expect_format("fixed aligned", format_fixed_aligned, "  12_345.500000|", 12345.5);
+
+  // Without a separator nothing is grouped
+  auto format_plain = mould::compile<plain>();
+  test::expect_format("plain", format_plain, "1234567|1234.5|", 1234567, 1234.5);
+  return test::result();
+}
@@ -0,0 +1,84 @@
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "check.hpp"
+
+static constexpr char bytes[] = "{:B}|";
+static constexpr char bytes_whole[] = "{:.0B}|";
+static constexpr char bytes_fine[] = "{:.3B}|";
+static constexpr char bytes_aligned[] = "{:>10B}|";
+static constexpr char span[] = "{:t}|";
+static constexpr char span_whole[] = "{:.0t}|";
+static constexpr char span_fine[] = "{:.9t}|";
+static constexpr char span_aligned[] = "{:<9t}|";
+static constexpr char percent[] = "{:%}|";
+static constexpr char percent_fine[] = "{:.1%}|";
+static constexpr char percent_aligned[] = "{:>8.0%}|";
+
+int main() {
+  constexpr int64_t minimum = std::numeric_limits<int64_t>::min();
+
+  auto format_bytes = mould::compile<bytes>();
+  test::expect_format("bytes zero", format_bytes, "0 B|", 0);
+  test::expect_format("bytes below unit", format_bytes, "1023 B|", 1023);
+  test::expect_format("bytes unit", format_bytes, "1.0 KiB|", 1024);
+  test::expect_format("bytes fraction", format_bytes, "1.5 KiB|", 1536);
+  test::expect_format("bytes negative", format_bytes, "-2.0 KiB|", -2048);
+  test::expect_format("bytes small negative", format_bytes, "-128 B|", int8_t(-128));
+  test::expect_format("bytes maximum", format_bytes, "16.0 EiB|", std::numeric_limits<uint64_t>::max());
+  test::expect_format("bytes minimum", format_bytes, "-8.0 EiB|", minimum);
+
+  // Rounding up to 1024 moves on to the next unit
+  test::expect_format("bytes roll-over", format_bytes, "1.0 MiB|", 1048575);
+  auto format_bytes_whole = mould::compile<bytes_whole>();
+  test::expect_format("bytes whole roll-over", format_bytes_whole, "1 MiB|", 1048575);
+  test::expect_format("bytes whole", format_bytes_whole, "2 KiB|", 1536);
+  test::expect_format("bytes whole negative", format_bytes_whole, "-1 MiB|", -1048575);
+  auto format_bytes_fine = mould::compile<bytes_fine>();
+  test::expect_format("bytes no roll-over", format_bytes_fine, "1023.999 KiB|", 1048575u);
+  test::expect_format("bytes fine minimum", format_bytes_fine, "-8.000 EiB|", minimum);
+  auto format_bytes_aligned = mould::compile<bytes_aligned>();
+  test::expect_format("bytes aligned", format_bytes_aligned, "   5.0 GiB|", 5ull << 30);
+  test::expect_format("bytes range", format_bytes, "[1 B, 1.0 KiB]|", std::vector<int>{1, 1024});
+
+  auto format_span = mould::compile<span>();
+  test::expect_format("span zero", format_span, "0 ns|", 0);
+  test::expect_format("span below unit", format_span, "999 ns|", 999);
+  test::expect_format("span fraction", format_span, "12.3 ms|", 12345678);
+  test::expect_format("span roll-over", format_span, "1.0 ms|", 999999);
+  test::expect_format("span seconds", format_span, "1.5 s|", 1500000000ll);
+  test::expect_format("span long", format_span, "3600.0 s|", 3600000000000ll);
+  test::expect_format("span negative", format_span, "-2.5 us|", -2500);
+  test::expect_format("span negative roll-over", format_span, "-1.0 s|", -999999999);
+  test::expect_format("span minimum", format_span, "-9223372036.9 s|", minimum);
+  test::expect_format("span maximum", format_span, "18446744073.7 s|", std::numeric_limits<uint64_t>::max());
+  auto format_span_whole = mould::compile<span_whole>();
+  test::expect_format("span whole", format_span_whole, "2 us|", 1500);
+  test::expect_format("span whole roll-over", format_span_whole, "1 s|", 999500000);
+  auto format_span_fine = mould::compile<span_fine>();
+  test::expect_format("span fine", format_span_fine, "1.234567891 s|", 1234567891ll);
+  test::expect_format("span fine limited", format_span_fine, "1.234 us|", 1234);
+  test::expect_format("span fine minimum", format_span_fine, "-9223372036.854775808 s|", minimum);
+
+  // Durations are converted to nanoseconds
+  test::expect_format("duration milliseconds", format_span, "250.0 ms|", std::chrono::milliseconds(250));
+  test::expect_format("duration seconds", format_span, "2.0 s|", std::chrono::seconds(2));
+  test::expect_format("duration minutes", format_span, "90.0 s|", std::chrono::minutes(1) + std::chrono::seconds(30));
+  test::expect_format("duration negative", format_span, "-1.5 us|", std::chrono::nanoseconds(-1500));
+  test::expect_format("duration minimum", format_span, "-9223372036.9 s|", std::chrono::nanoseconds::min());
+  auto format_span_aligned = mould::compile<span_aligned>();
+  test::expect_format("span aligned", format_span_aligned, "1.0 us   |", std::chrono::microseconds(1));
+  test::expect_format("span range", format_span, "[1.0 us, 2.0 ms]|", std::vector<long>{1000, 2000000});
+
+  auto format_percent = mould::compile<percent>();
+  test::expect_format("percent", format_percent, "25.000000%|", 0.25);
+  auto format_percent_fine = mould::compile<percent_fine>();
+  test::expect_format("percent fine", format_percent_fine, "12.3%|", 0.1234);
+  test::expect_format("percent negative", format_percent_fine, "-50.0%|", -0.5);
+  test::expect_format("percent above", format_percent_fine, "250.0%|", 2.5);
+  auto format_percent_aligned = mould::compile<percent_aligned>();
+  test::expect_format("percent aligned", format_percent_aligned, "    100%|", 1.0);
+  return test::result();
+}
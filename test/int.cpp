@@ -0,0 +1,78 @@
+#include <array>
+#include <climits>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+#include "check.hpp"
+
+// The text of `{:0<width><kind>}|`
+template<unsigned Width, char Kind>
+constexpr std::array<char, 10> zero_padded_text() {
+  std::array<char, 10> text = {};
+  size_t at = 0;
+  for(char c : { '{', ':', '0' })
+    text[at++] = c;
+  if(Width >= 10)
+    text[at++] = static_cast<char>('0' + Width/10);
+  text[at++] = static_cast<char>('0' + Width % 10);
+  for(char c : { Kind, '}', '|' })
+    text[at++] = c;
+  return text;
+}
+
+template<unsigned Width, char Kind, typename = std::make_index_sequence<10>>
+struct ZeroPadded;
+
+template<unsigned Width, char Kind, size_t ... Indices>
+struct ZeroPadded<Width, Kind, std::index_sequence<Indices...>> {
+  static constexpr char text[] = { zero_padded_text<Width, Kind>()[Indices]... };
+};
+
+// Python style: the sign, then zeros, then the digits of the magnitude
+std::string reference(int value, unsigned width, char kind) {
+  const unsigned long long magnitude = value < 0
+    ? 0 - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+  const char* conversion = kind == 'd' ? "%llu" : kind == 'x' ? "%llx" : "%llX";
+  char digits[32];
+  const int length = std::snprintf(digits, sizeof(digits), conversion, magnitude);
+  const unsigned content = length + (value < 0);
+  std::string output = value < 0 ? "-" : "";
+  output.append(width > content ? width - content : 0, '0');
+  output.append(digits, length);
+  return output + "|";
+}
+
+constexpr int values[] = { 0, 1, 9, 10, 15, 16, 255, 4096, 65535, 123456789,
+  INT_MAX, -1, -9, -255, -65536, -123456789, INT_MIN + 1, INT_MIN };
+
+template<unsigned Width, char Kind>
+void expect_zero_padded() {
+  auto format = mould::compile<ZeroPadded<Width, Kind>::text>();
+  for(int value : values) {
+    test::expect_format(ZeroPadded<Width, Kind>::text + std::to_string(value), format,
+      reference(value, Width, Kind), value);
+  }
+}
+
+// Up to the widest kernel and beyond it
+template<unsigned ... Widths>
+void expect_widths(std::integer_sequence<unsigned, Widths...>) {
+  (expect_zero_padded<Widths + 1, 'd'>(), ...);
+  (expect_zero_padded<Widths + 1, 'x'>(), ...);
+  (expect_zero_padded<Widths + 1, 'X'>(), ...);
+}
+
+// Formats which look zero padded but must not take the kernels
+static constexpr char not_padded[] = "{:08}|{:+08d}|{: 08d}|{:<08x}|{:^08X}|{:0=8d}";
+
+int main() {
+  expect_widths(std::make_integer_sequence<unsigned, mould::internal::max_zero_padded_width + 4>{});
+
+  auto format_not_padded = mould::compile<not_padded>();
+  test::expect_format("not padded", format_not_padded,
+    "00000042|+0000042| 0000042|ff000000|000FF000|-0000042", 42, 42, 42, 255, 255, -42);
+  test::expect_format("not padded negative", format_not_padded,
+    "-0000042|-0000042|-0000042|-ff00000|00-FF000|-0000042", -42, -42, -42, -255, -255, -42);
+  return test::result();
+}
@@ -0,0 +1,61 @@
+#include <sstream>
+#include <string>
+
+#include "check.hpp"
+
+static constexpr char person[] = "{name} is {age:>4} years";
+static constexpr char mixed[] = "[{} {name} {}]";
+static constexpr char indexed[] = "[{1} {name} {0}]";
+static constexpr char nested[] = "[{value:>{}}]";
+static constexpr char letter[] = "{name:>8}][{x:}][{x}]";
+static constexpr char kinds[] = "{d}{s}|{x}|{_d}|{a<3}|{id}|{v:x}";
+static constexpr char missing[] = "{missing}";
+
+int main() {
+  using mould::arg;
+
+  auto format_person = mould::compile<person>();
+  test::expect_format("person", format_person, "Ann is   42 years", arg<"age">(42), arg<"name">("Ann"));
+  test::expect_format("string", format_person, "Bob is    7 years", arg<"name">(std::string("Bob")), arg<"age">(7));
+
+  // Positional fields skip the named arguments
+  auto format_mixed = mould::compile<mixed>();
+  test::expect_format("mixed", format_mixed, "[1 99 2]", 1, arg<"name">(99), 2);
+  auto format_indexed = mould::compile<indexed>();
+  test::expect_format("indexed", format_indexed, "[2 99 1]", arg<"name">(99), 1, 2);
+  auto format_nested = mould::compile<nested>();
+  test::expect_format("nested", format_nested, "[    5]", arg<"value">(5), 5);
+
+  // `{x:}` is a name, `{x}` the hex kind of the next positional argument
+  auto format_letter = mould::compile<letter>();
+  test::expect_format("letter", format_letter, "    name][255][c]", arg<"name">("name"), arg<"x">(255), 12);
+
+  // Single letters and other specs without a name keep their meaning
+  auto format_kinds = mould::compile<kinds>();
+  test::expect_format("kinds", format_kinds, "-4ab|ff|7|5aa|9|a", -4, "ab", 255, 7, 5, arg<"id">(9), arg<"v">(10));
+
+  auto format_missing = mould::compile<missing>();
+  test::expect("missing", mould::format(format_missing, arg<"other">(1)), "Error while formatting");
+
+  // Deferred and queued arguments keep their name and copy their value
+  std::string records;
+  {
+    std::string name = "Zed";
+    mould::defer(format_person, arg<"name">(name), arg<"age">(3)).append_to(records);
+    name = "changed";
+  }
+  std::string deferred;
+  mould::format_deferred(deferred, records.data(), records.size());
+  test::expect("deferred", deferred, "Zed is    3 years");
+
+  std::ostringstream queued;
+  {
+    mould::AsyncPool pool{1};
+    mould::AsyncSink* sink = pool.add_sink(queued);
+    std::string name = "Cy";
+    mould::async_write(format_person, *sink, arg<"name">(name.c_str()), arg<"age">(9));
+    name.assign(32, 'x');
+  }
+  test::expect("async", queued.str(), "Cy is    9 years");
+  return test::result();
+}
@@ -0,0 +1,33 @@
+#include <string>
+
+#include "check.hpp"
+
+static constexpr char width[] = "[{:{}}|{}]";
+static constexpr char precision[] = "[{:.{}f}|{:>{}}]";
+static constexpr char fill[] = "[{:{}^{}.{}f}]";
+static constexpr char indexed[] = "[{0:>{1}}|{2:{1}}]";
+static constexpr char zero[] = "[{:0{}d}]";
+
+int main() {
+  auto format_width = mould::compile<width>();
+  test::expect_format("width", format_width, "[   42|x]", 42, 5, "x");
+  test::expect_format("negative width", format_width, "[42|x]", 42, -3, "x");
+
+  auto format_precision = mould::compile<precision>();
+  test::expect_format("precision", format_precision, "[3.14|   ab]", 3.14159, 2, "ab", 5);
+
+  auto format_fill = mould::compile<fill>();
+  test::expect_format("fill", format_fill, "[**1.500**]", 1.5, '*', 9, 3);
+
+  auto format_indexed = mould::compile<indexed>();
+  test::expect_format("indexed", format_indexed, "[  7|x  ]", 7, 3, "x");
+
+  auto format_zero = mould::compile<zero>();
+  test::expect_format("zero", format_zero, "[00042]", 42, 5);
+
+  // A value that is not an integer is an error, a compile error in the
+  // constexpr driver
+  test::expect("not an integer", mould::format(format_width, 7, "abc", "x"), "Error while formatting");
+  test::expect("double", mould::format(format_width, 7, 2.5, "x"), "Error while formatting");
+  return test::result();
+}
@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+#include "check.hpp"
+
+static constexpr char value[] = "{}|";
+static constexpr char aligned[] = "{:>17}|";
+static constexpr char cases[] = "{}|{:x}|{:X}";
+
+// The address of eight 16 bit groups
+mould::Ipv6Address ipv6(std::initializer_list<uint16_t> groups) {
+  mould::Ipv6Address address = {};
+  unsigned at = 0;
+  for(uint16_t group : groups) {
+    address.bytes[at++] = static_cast<uint8_t>(group >> 8);
+    address.bytes[at++] = static_cast<uint8_t>(group);
+  }
+  return address;
+}
+
+int main() {
+  auto format_value = mould::compile<value>();
+  auto format_aligned = mould::compile<aligned>();
+
+  test::expect_format("ipv4", format_value, "192.168.0.1|", mould::Ipv4Address{{192, 168, 0, 1}});
+  test::expect_format("ipv4 zero", format_value, "0.0.0.0|", mould::Ipv4Address{{0, 0, 0, 0}});
+  test::expect_format("ipv4 aligned", format_aligned, "       10.0.0.255|", mould::Ipv4Address{{10, 0, 0, 255}});
+
+  // RFC 5952: no leading zeros, the longest run of zero groups compressed
+  test::expect_format("leading zeros", format_value, "2001:db8:a:b0:c00:1:ffff:ffff|",
+    ipv6({0x2001, 0x0db8, 0x000a, 0x00b0, 0x0c00, 0x0001, 0xffff, 0xffff}));
+  test::expect_format("longest run", format_value, "1:0:0:2::3|",
+    ipv6({1, 0, 0, 2, 0, 0, 0, 3}));
+  test::expect_format("first of equal runs", format_value, "2001:db8::1:0:0:1|",
+    ipv6({0x2001, 0xdb8, 0, 0, 1, 0, 0, 1}));
+  test::expect_format("single zero group", format_value, "2001:db8:0:1:1:1:1:1|",
+    ipv6({0x2001, 0xdb8, 0, 1, 1, 1, 1, 1}));
+  test::expect_format("single zero groups", format_value, "0:1:0:1:0:1:0:1|",
+    ipv6({0, 1, 0, 1, 0, 1, 0, 1}));
+  test::expect_format("unspecified", format_value, "::|", ipv6({}));
+  test::expect_format("loopback", format_value, "::1|", ipv6({0, 0, 0, 0, 0, 0, 0, 1}));
+  test::expect_format("trailing run", format_value, "fe80::|", ipv6({0xfe80}));
+  test::expect_format("inner run", format_value, "1::8|", ipv6({1, 0, 0, 0, 0, 0, 0, 8}));
+  test::expect_format("widest", format_value, "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff|",
+    ipv6({0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff}));
+
+  // IPv4 mapped addresses only, not other addresses with a zero prefix
+  test::expect_format("mapped", format_value, "::ffff:192.0.2.1|",
+    ipv6({0, 0, 0, 0, 0, 0xffff, 0xc000, 0x0201}));
+  test::expect_format("mapped zero", format_value, "::ffff:0.0.0.0|",
+    ipv6({0, 0, 0, 0, 0, 0xffff}));
+  test::expect_format("not mapped", format_value, "::fffe:c000:201|",
+    ipv6({0, 0, 0, 0, 0, 0xfffe, 0xc000, 0x0201}));
+  test::expect_format("not mapped prefix", format_value, "::1:ffff:c000:201|",
+    ipv6({0, 0, 0, 0, 1, 0xffff, 0xc000, 0x0201}));
+
+  test::expect_format("ipv6 aligned", format_aligned, "      2001:db8::1|",
+    ipv6({0x2001, 0xdb8, 0, 0, 0, 0, 0, 1}));
+  test::expect_format("range", format_value, "[1.2.3.4, 5.6.7.8]|",
+    std::vector<mould::Ipv4Address>{{{1, 2, 3, 4}}, {{5, 6, 7, 8}}});
+
+#ifdef CPP_MOULD_HAS_NETINET
+  in_addr v4;
+  const uint8_t v4_bytes[] = { 255, 255, 255, 255 };
+  std::memcpy(&v4, v4_bytes, sizeof(v4));
+  test::expect_format("in_addr", format_value, "255.255.255.255|", v4);
+
+  in6_addr v6;
+  const mould::Ipv6Address v6_bytes = ipv6({0x2001, 0xdb8, 0, 0, 1, 0, 0, 1});
+  std::memcpy(&v6, v6_bytes.bytes.data(), sizeof(v6));
+  test::expect_format("in6_addr", format_value, "2001:db8::1:0:0:1|", v6);
+#endif
+
+  auto format_cases = mould::compile<cases>();
+  const mould::Uuid uuid = {{0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3,
+    0xa4, 0x56, 0x42, 0x66, 0x14, 0x17, 0x40, 0x00}};
+  test::expect_format("uuid", format_cases,
+    "123e4567-e89b-12d3-a456-426614174000|123e4567-e89b-12d3-a456-426614174000|"
+    "123E4567-E89B-12D3-A456-426614174000", uuid, uuid, uuid);
+  const mould::Uuid nil = {};
+  test::expect_format("nil uuid", format_value, "00000000-0000-0000-0000-000000000000|", nil);
+  return test::result();
+}
@@ -0,0 +1,87 @@
+#include <array>
+#include <cstdint>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+
+static constexpr char value[] = "{}|";
+static constexpr char separator[] = "<{:|; }>";
+static constexpr char all[] = "{:|<|,|>}";
+static constexpr char element[] = "{:>4d|(|:|)}";
+static constexpr char precision[] = "{:.2f|[|; |]}";
+static constexpr char braces[] = "{:|{{|, |}}}|{:|}}{{|-|{{}}}";
+static constexpr char unbalanced[] = "{:|{{|,|}|{}";
+static constexpr char empty[] = "{:|||}|";
+static constexpr char fill[] = "{:*>4}|{:|>4}";
+
+// Both drivers and a stream, whose buffer takes the single reserve path
+template<typename Format, typename T>
+void expect_range(std::string_view name, Format& format, std::string_view expected, const T& range) {
+  test::expect_format(name, format, expected, range);
+  std::ostringstream stream;
+  mould::write_constexpr(format, stream, range);
+  test::expect(name, stream.str(), expected);
+}
+
+// If the text starts with a complete specifier
+template<size_t N>
+constexpr bool parses(const char (&text)[N]) {
+  auto input = mould::internal::format_buffer(text);
+  mould::internal::FormatSpecifier<const char> specifier = {};
+  return mould::internal::get_format_specifier(input, specifier);
+}
+
+int main() {
+  const std::vector<int> numbers{1, -20, 300};
+
+  auto format_value = mould::compile<value>();
+  expect_range("default", format_value, "[1, -20, 300]|", numbers);
+  expect_range("empty", format_value, "[]|", std::vector<int>{});
+  expect_range("array", format_value, "[1.5, 0.25]|", std::array<double, 2>{1.5, 0.25});
+  const int raw[] = {7, 8};
+  expect_range("span", format_value, "[7, 8]|", std::span<const int>(raw));
+  expect_range("nested", format_value, "[[1], [2, 3]]|", std::vector<std::vector<int>>{{1}, {2, 3}});
+
+  auto format_separator = mould::compile<separator>();
+  expect_range("separator", format_separator, "<1; -20; 300>", numbers);
+
+  // A '|' starts the delimiters, it is not the fill of an alignment '<'
+  auto format_all = mould::compile<all>();
+  expect_range("delimiters", format_all, "<4,5>", std::vector<int>{4, 5});
+  expect_range("delimiters single", format_all, "<4>", std::vector<int>{4});
+  expect_range("delimiters empty", format_all, "<>", std::vector<int>{});
+
+  auto format_element = mould::compile<element>();
+  expect_range("element format", format_element, "(   1: -20: 300)", numbers);
+  auto format_precision = mould::compile<precision>();
+  expect_range("element precision", format_precision, "[1.50; 0.25]", std::vector<double>{1.5, 0.25});
+
+  // Braces in delimiters are doubled, also when they are not balanced
+  auto format_braces = mould::compile<braces>();
+  test::expect_format("braces", format_braces, "{4, 5}|}{4-5{}", std::vector<int>{4, 5}, std::vector<int>{4, 5});
+  auto format_unbalanced = mould::compile<unbalanced>();
+  test::expect_format("unbalanced", format_unbalanced, "{4,5|[6, 7]", std::vector<int>{4, 5}, std::vector<int>{6, 7});
+  auto format_empty = mould::compile<empty>();
+  expect_range("no delimiters", format_empty, "45|", std::vector<int>{4, 5});
+
+  // A fill other than '|' and an alignment apply to the elements, '|' is
+  // the start of the delimiters
+  auto format_fill = mould::compile<fill>();
+  test::expect_format("fill", format_fill, "[***4, ***5]|4>45", std::vector<int>{4, 5}, std::vector<int>{4, 5});
+
+  // A brace in the delimiters which is not doubled is not a specifier
+  static_assert(parses("{:|{{|, |}}}") && parses("{:|a}b"));
+  static_assert(!parses("{:|{}") && !parses("{:|a{b}") && !parses("{:|a}}"));
+
+  std::vector<int> large(1000);
+  std::string expected = "[";
+  for(int i = 0; i < 1000; i++) {
+    large[i] = i*1000003;
+    expected += (i ? ", " : "") + std::to_string(large[i]);
+  }
+  expect_range("large", format_value, expected + "]|", large);
+  return test::result();
+}
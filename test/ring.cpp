@@ -0,0 +1,100 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "check.hpp"
+
+static constexpr char line[] = "{} {} {}\n";
+
+constexpr int writers = 4;
+constexpr int lines = 2000;
+
+// Each writer formats its numbered lines, every tenth longer than the
+// reservation
+void write_lines(mould::Ring& ring, int writer) {
+  auto format = mould::compile<line>();
+  const std::string padding(300, 'x');
+  for(int i = 0; i < lines; i++)
+    mould::write_ring(format, ring, writer, i, i % 10 ? std::string_view{"-"} : padding);
+}
+
+// All lines arrive whole, once and in the order of their writer
+void expect_lines(std::string_view name, std::string_view output) {
+  std::vector<int> next(writers, 0);
+  const std::string padding(300, 'x');
+  while(!output.empty()) {
+    const size_t end = output.find('\n');
+    const std::string text{output.substr(0, end)};
+    output.remove_prefix(end == output.npos ? output.size() : end + 1);
+
+    int writer = -1, index = -1, rest = 0;
+    std::sscanf(text.c_str(), "%d %d %n", &writer, &index, &rest);
+    if(writer < 0 || writer >= writers || index != next[writer]
+      || text.substr(rest) != (index % 10 ? "-" : padding))
+    {
+      test::expect(name, text, "a line in order");
+      return;
+    }
+    next[writer]++;
+  }
+  for(int writer = 0; writer < writers; writer++)
+    test::expect(name, next[writer] == lines);
+}
+
+// Runs the writers while `read` is called until they are done and the ring
+// is empty
+template<typename Read>
+void run(mould::Ring& ring, Read&& read) {
+  std::vector<std::thread> threads;
+  for(int writer = 0; writer < writers; writer++)
+    threads.emplace_back(write_lines, std::ref(ring), writer);
+
+  std::atomic<bool> done{false};
+  std::thread reader([&] {
+    while(true) {
+      const bool finished = done.load();
+      if(!read() && finished)
+        break;
+    }
+  });
+  for(auto& thread : threads)
+    thread.join();
+  done = true;
+  reader.join();
+}
+
+int main() {
+  // A small ring, such that the writers wait for the reader
+  {
+    mould::Ring ring{1 << 14};
+    std::string output;
+    run(ring, [&] {
+      return ring.consume([&](const std::string_view* records, size_t count) {
+        for(size_t i = 0; i < count; i++)
+          output.append(records[i]);
+      });
+    });
+    expect_lines("consume", output);
+  }
+
+#ifdef CPP_MOULD_HAS_WRITEV
+  {
+    char path[] = "/tmp/mould_ringXXXXXX";
+    const int fd = mkstemp(path);
+    test::expect("temporary file", fd >= 0);
+    mould::Ring ring{1 << 16};
+    run(ring, [&] { return ring.drain(fd); });
+
+    std::string output(lseek(fd, 0, SEEK_END), '\0');
+    test::expect("read back", pread(fd, output.data(), output.size(), 0) == static_cast<ssize_t>(output.size()));
+    close(fd);
+    unlink(path);
+    expect_lines("drain", output);
+  }
+#endif
+  return test::result();
+}
@@ -0,0 +1,61 @@
+#include <cstring>
+#include <string>
+#include <sys/mman.h>
+
+#include "check.hpp"
+
+#include <cpp_mould/simd.hpp>
+
+static constexpr char text[] = "{}|";
+
+int main() {
+  using mould::internal::copy_c_string;
+  using mould::internal::str_len;
+  constexpr size_t page = mould::internal::simd::page_size;
+
+  // Three readable pages followed by one that faults on any access
+  char* const pages = static_cast<char*>(mmap(nullptr, 4*page, PROT_READ | PROT_WRITE,
+    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  test::expect("mapped", pages != MAP_FAILED);
+  mprotect(pages + 3*page, page, PROT_NONE);
+
+  // Strings that start at any offset before a page boundary and continue
+  // long after it are copied whole
+  char copy[512];
+  for(size_t before = 0; before < 70; before++) {
+    for(size_t length : { size_t{0}, size_t{5}, before, before + 1, size_t{300} }) {
+      char* const string = pages + page - before;
+      std::memset(string, 'a', length);
+      string[length] = '\0';
+      std::memset(copy, '-', sizeof(copy));
+      const std::string name = "across " + std::to_string(before) + " " + std::to_string(length);
+      test::expect(name, copy_c_string(copy, string, sizeof(copy)) == length);
+      test::expect(name, std::string_view(copy, length), std::string_view(string, length));
+      test::expect(name, str_len(string) == length);
+    }
+  }
+
+  // A string that ends the last readable page is read only up to its end
+  for(size_t length = 0; length < 70; length++) {
+    char* const string = pages + 3*page - length - 1;
+    std::memset(string, 'b', length);
+    string[length] = '\0';
+    const std::string name = "last page " + std::to_string(length);
+    test::expect(name, copy_c_string(copy, string, sizeof(copy)) == length);
+    test::expect(name, str_len(string) == length);
+    test::expect(name, mould::format(mould::compile<text>(), static_cast<const char*>(string)),
+      std::string(length, 'b') + "|");
+  }
+
+  // Longer strings end at the capacity
+  char* const string = pages + page - 3;
+  std::memset(string, 'c', 600);
+  string[600] = '\0';
+  test::expect("capacity", copy_c_string(copy, string, 100) == 100);
+  test::expect("capacity", std::string_view(copy, 100), std::string(100, 'c'));
+  test::expect("chunks", mould::format(mould::compile<text>(), static_cast<const char*>(string)),
+    std::string(600, 'c') + "|");
+
+  munmap(pages, 4*page);
+  return test::result();
+}
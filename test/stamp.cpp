@@ -0,0 +1,43 @@
+#include <string>
+
+#include "check.hpp"
+
+static constexpr char line[] = "id={:08d} name={:>10} v={:8.3f} [{:<4}]\n";
+static constexpr char field[] = "{:5}";
+
+int main() {
+  auto format_line = mould::compile<line>();
+  mould::Stamp stamp{format_line};
+  static_assert(decltype(stamp)::size == 46);
+  test::expect("skeleton", stamp.text(), "id=         name=           v=         [    ]\n");
+
+  // Each update overwrites the fields as the format writes them
+  for(int i = 0; i < 3; i++) {
+    const std::string name = i == 1 ? "bob" : "alexandria";
+    test::expect("update", stamp.update(i*12345, name, i*1.5, "ab"));
+    std::string expected;
+    mould::format_constexpr(format_line, expected, i*12345, name, i*1.5, "ab");
+    test::expect("update " + std::to_string(i), stamp.text(), expected);
+  }
+  test::expect("too long", !stamp.update(1, std::string("much too long name"), 1.0, "ab"));
+
+  auto format_field = mould::compile<field>();
+  mould::Stamp number{format_field};
+  number.update(123);
+  test::expect("number", number.text(), "  123");
+  number.update(std::string("ab"));
+  test::expect("text", number.text(), "ab   ");
+
+  // Many lines in one buffer from the skeleton
+  using Line = decltype(stamp);
+  std::string lines;
+  for(int i = 0; i < 3; i++)
+    lines += Line::skeleton();
+  for(int i = 0; i < 3; i++)
+    Line::fill(lines.data() + i*Line::size, i, std::string("n"), 0.25, "c");
+  std::string expected;
+  for(int i = 0; i < 3; i++)
+    mould::format_constexpr(format_line, expected, i, std::string("n"), 0.25, "c");
+  test::expect("lines", lines, expected);
+  return test::result();
+}
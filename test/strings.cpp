@@ -0,0 +1,49 @@
+#include <string>
+#include <string_view>
+
+#include "check.hpp"
+
+static constexpr char precisions[] = "{:.0}|{:.1}|{:.3}|{:.5}|{:.9}|{}";
+static constexpr char padded[] = "[{:>6.2}|{:<6.3}|{:^7.4}]";
+static constexpr char dynamic[] = "{:.{}}|";
+
+template<typename T>
+void expect_truncated(std::string_view name, const T& value) {
+  auto format_precisions = mould::compile<precisions>();
+  test::expect_format(name, format_precisions, "|a|abc|abcde|abcdef|abcdef",
+    value, value, value, value, value, value);
+  auto format_padded = mould::compile<padded>();
+  test::expect_format(name, format_padded, "[    ab|abc   | abcd  ]", value, value, value);
+  auto format_dynamic = mould::compile<dynamic>();
+  for(size_t precision = 0; precision < 8; precision++)
+    test::expect_format(name, format_dynamic, std::string("abcdef").substr(0, precision) + "|", value, precision);
+}
+
+int main() {
+  const char* pointer = "abcdef";
+  expect_truncated("char*", pointer);
+  char* mutable_pointer = const_cast<char*>(pointer);
+  expect_truncated("mutable char*", mutable_pointer);
+
+  // The array ends at its first nul character or at its end
+  const char array[] = "abcdef";
+  expect_truncated("char[N]", array);
+  const char embedded[] = "abcdef\0ghi";
+  expect_truncated("char[N] with nul", embedded);
+  const char unterminated[6] = { 'a', 'b', 'c', 'd', 'e', 'f' };
+  expect_truncated("char[N] without nul", unterminated);
+
+  expect_truncated("std::string", std::string("abcdef"));
+  expect_truncated("std::string_view", std::string_view("abcdef"));
+
+  // A precision only reads as far as it needs, not to the nul character
+  const char longer[] = { 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j' };
+  auto format_dynamic = mould::compile<dynamic>();
+  test::expect_format("char* unterminated", format_dynamic, "abcdef|", static_cast<const char*>(longer), 6);
+
+  // Strings keep an embedded nul character, truncated or not
+  const std::string with_nul("ab\0cd", 5);
+  test::expect_format("std::string nul", format_dynamic, std::string("ab\0c|", 5), with_nul, 4);
+  test::expect_format("std::string_view nul", format_dynamic, std::string("ab\0cd|", 6), std::string_view(with_nul), 9);
+  return test::result();
+}
@@ -0,0 +1,34 @@
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "check.hpp"
+
+static constexpr char mixed[] = "| {} | {:>} | {:.2f} | {:^6} |\n";
+static constexpr char padded[] = "[{:08d}|{:>3}]\n";
+
+int main() {
+  auto format_mixed = mould::compile<mixed>();
+  std::vector<std::tuple<std::string, int, double, std::string>> rows = {
+    {"alpha", 1, 3.14159, "x"}, {"be", -12345, 100.0, "yyy"}, {"gammadelta", 7, -0.5, "centered"}};
+  std::string output = "T\n";
+  mould::format_table(format_mixed, rows, output);
+  test::expect("table", output,
+    "T\n"
+    "| alpha      |      1 |   3.14 |    x     |\n"
+    "| be         | -12345 | 100.00 |   yyy    |\n"
+    "| gammadelta |      7 |  -0.50 | centered |\n");
+
+  rows.clear();
+  std::string empty;
+  mould::format_table(format_mixed, rows, empty);
+  test::expect("no rows", empty, "");
+
+  // A zero padded field wider than its format takes the width of the column
+  auto format_padded = mould::compile<padded>();
+  std::vector<std::tuple<int, int>> numbers = {{5, 1}, {123456789, 22}};
+  std::string columns;
+  mould::format_table(format_padded, numbers, columns);
+  test::expect("zero padded", columns, "[000000005|  1]\n[123456789| 22]\n");
+  return test::result();
+}